@@ -0,0 +1,160 @@
+#pragma once
+
+#include "bitboard.h"
+#include <cstdint>
+
+// The Attacks class provides precomputed attack tables for sliding pieces (bishops, rooks and queens).
+// It uses "magic bitboards": the relevant blockers on a slider's rays are multiplied by a magic number
+// and shifted, producing a unique index into a table of precomputed attack sets.
+// A slider's attacks are therefore one mask, multiply, shift and lookup rather than a walk along each ray.
+// When built with OLIVIATHAN_PEXT, a second set of tables indexed by the BMI2 PEXT instruction is also
+// available. It is selected at startup if the CPU has fast BMI2 and can be switched at runtime;
+// the magic tables remain as the portable fallback.
+// Attacks::init() must be called once at startup before any lookup is made.
+// Knight, king and pawn attacks do not depend on occupancy; their tables are built at compile time.
+
+namespace AttackTables {
+
+    // Helper: the squares reached from a square by each (file, rank) step that stays on the board.
+    constexpr Bitboard leaperAttacks(int square, const int steps[][2], int count) {
+        Bitboard attacks = 0;
+        int file = square % 8, rank = square / 8;
+        for (int i = 0; i < count; ++i) {
+            int toFile = file + steps[i][0];
+            int toRank = rank + steps[i][1];
+            if (toFile >= 0 && toFile < 8 && toRank >= 0 && toRank < 8)
+                attacks |= 1ULL << (toRank * 8 + toFile);
+        }
+        return attacks;
+    }
+
+    struct Tables {
+        Bitboard knight[64];
+        Bitboard king[64];
+        Bitboard pawn[2][64]; // Indexed [colour][square]: the squares a pawn of that colour attacks
+
+        constexpr Tables() : knight(), king(), pawn() {
+            const int knightSteps[8][2] = { {1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2} };
+            const int kingSteps[8][2] = { {1, 1}, {1, 0}, {1, -1}, {0, -1}, {-1, -1}, {-1, 0}, {-1, 1}, {0, 1} };
+            const int whitePawnSteps[2][2] = { {-1, 1}, {1, 1} };
+            const int blackPawnSteps[2][2] = { {-1, -1}, {1, -1} };
+            for (int sq = 0; sq < 64; ++sq) {
+                knight[sq] = leaperAttacks(sq, knightSteps, 8);
+                king[sq] = leaperAttacks(sq, kingSteps, 8);
+                pawn[0][sq] = leaperAttacks(sq, whitePawnSteps, 2);
+                pawn[1][sq] = leaperAttacks(sq, blackPawnSteps, 2);
+            }
+        }
+    };
+
+    inline constexpr Tables tables{};
+}
+
+class Attacks {
+public:
+    // Builds the magic numbers and attack tables. Safe to call more than once.
+    static void init();
+
+    // Slider attack backends
+    enum Backend : uint8_t {
+        MAGIC = 0, // Magic multiplication (portable)
+        PEXT       // BMI2 parallel bit extract (x86-64 with BMI2 only)
+    };
+
+    // Returns the backend currently used for slider lookups.
+    static Backend getBackend() { return backend; }
+
+    // Selects the slider backend. Returns false (leaving the backend unchanged)
+    // if PEXT is requested but was not compiled in or is not supported by this CPU.
+    static bool setBackend(Backend requested);
+
+    // Checks whether this binary and CPU can use the PEXT backend.
+    static bool pextSupported();
+
+    // Returns the squares attacked by a bishop on the given square for the given board occupancy.
+    static Bitboard bishopAttacks(int square, Bitboard occupancy) {
+#ifdef OLIVIATHAN_PEXT
+        if (backend == PEXT)
+            return bishopAttacksPext(square, occupancy);
+#endif
+        return bishopMagics[square].attacks[bishopMagics[square].index(occupancy)];
+    }
+
+    // Returns the squares attacked by a rook on the given square for the given board occupancy.
+    static Bitboard rookAttacks(int square, Bitboard occupancy) {
+#ifdef OLIVIATHAN_PEXT
+        if (backend == PEXT)
+            return rookAttacksPext(square, occupancy);
+#endif
+        return rookMagics[square].attacks[rookMagics[square].index(occupancy)];
+    }
+
+    // Returns the squares attacked by a queen (union of bishop and rook attacks).
+    static Bitboard queenAttacks(int square, Bitboard occupancy) {
+        return bishopAttacks(square, occupancy) | rookAttacks(square, occupancy);
+    }
+
+    // Returns the squares attacked by a knight, king, or pawn of the given colour (0 = white, 1 = black).
+    static constexpr Bitboard knightAttacks(int square) { return AttackTables::tables.knight[square]; }
+    static constexpr Bitboard kingAttacks(int square) { return AttackTables::tables.king[square]; }
+    static constexpr Bitboard pawnAttacks(int colour, int square) { return AttackTables::tables.pawn[colour][square]; }
+
+    // Returns the squares strictly between two squares on a shared rank, file or diagonal (empty otherwise).
+    static Bitboard between(int a, int b) { return betweenTable[a][b]; }
+
+    // Returns the whole line (edge to edge, including both squares) through two aligned squares (empty otherwise).
+    // Used to keep a pinned piece on the line between its king and the pinning slider.
+    static Bitboard line(int a, int b) { return lineTable[a][b]; }
+
+private:
+    // Per-square magic entry: the relevant-blocker mask, the magic multiplier,
+    // the shift (64 minus the number of relevant bits) and this square's slice of the attack table.
+    struct Magic {
+        Bitboard mask;
+        Bitboard magic;
+        Bitboard* attacks;
+        unsigned shift;
+
+        unsigned index(Bitboard occupancy) const {
+            return static_cast<unsigned>(((occupancy & mask) * magic) >> shift);
+        }
+    };
+
+    static Magic bishopMagics[64];
+    static Magic rookMagics[64];
+
+    // Shared attack tables; each square's entry points into its own slice.
+    static Bitboard bishopTable[0x1480];
+    static Bitboard rookTable[0x19000];
+
+    // Backend in use; chosen by init() and changed by setBackend().
+    static Backend backend;
+
+    // Square-pair tables for between() and line()
+    static Bitboard betweenTable[64][64];
+    static Bitboard lineTable[64][64];
+
+    // Helper: fills the between and line tables (after the slider tables are built).
+    static void initLines();
+
+    // Helper: finds magics for every square and fills the table for one slider type.
+    static void initMagics(Magic magics[], Bitboard table[], const int directions[4][2]);
+
+#ifdef OLIVIATHAN_PEXT
+    // PEXT-indexed tables, using the same masks as the magic entries.
+    static Bitboard* bishopPextAttacks[64];
+    static Bitboard* rookPextAttacks[64];
+    static Bitboard bishopPextTable[0x1480];
+    static Bitboard rookPextTable[0x19000];
+
+    // PEXT lookups. These are compiled for BMI2 in attacks.cpp and only called once the CPU check has passed.
+    static Bitboard bishopAttacksPext(int square, Bitboard occupancy);
+    static Bitboard rookAttacksPext(int square, Bitboard occupancy);
+
+    // Helper: fills the PEXT table for one slider type.
+    static void initPext(const Magic magics[], Bitboard* entries[], Bitboard table[], const int directions[4][2]);
+#endif
+
+    // Helper: computes slider attacks the slow way, walking each ray until blocked (used only to build tables).
+    static Bitboard slidingAttacks(int square, Bitboard occupancy, const int directions[4][2]);
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// The Bitboards namespace provides the low-level helpers for working with 64-bit bitboards.
+// A bitboard holds one bit per square, using the same indexing as Board (bit 0 = a1, bit 63 = h8).
+// Everything here is inline so the compiler can reduce each helper to one or two instructions.
+
+using Bitboard = uint64_t;
+
+namespace Bitboards {
+
+    // Useful masks
+    constexpr Bitboard EMPTY_BB = 0ULL;
+    constexpr Bitboard FILE_A = 0x0101010101010101ULL;
+    constexpr Bitboard FILE_H = FILE_A << 7;
+    constexpr Bitboard RANK_1 = 0xFFULL;
+    constexpr Bitboard RANK_8 = RANK_1 << 56;
+
+    // Returns a bitboard with only the given square set.
+    constexpr Bitboard squareBB(int square) {
+        return 1ULL << square;
+    }
+
+    // Returns the mask for a whole file (0 = a-file) or rank (0 = first rank).
+    constexpr Bitboard fileBB(int file) {
+        return FILE_A << file;
+    }
+    constexpr Bitboard rankBB(int rank) {
+        return RANK_1 << (8 * rank);
+    }
+
+    // Checks whether a square is set in a bitboard.
+    constexpr bool testBit(Bitboard bb, int square) {
+        return (bb >> square) & 1ULL;
+    }
+
+    // Counts the number of set bits (pieces) in a bitboard.
+    inline int popCount(Bitboard bb) {
+#if defined(_MSC_VER)
+        return static_cast<int>(__popcnt64(bb));
+#else
+        return __builtin_popcountll(bb);
+#endif
+    }
+
+    // Returns the index of the least significant set bit. The bitboard must not be empty.
+    inline int lsb(Bitboard bb) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, bb);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctzll(bb);
+#endif
+    }
+
+    // Returns the index of the least significant set bit and clears it from the bitboard.
+    inline int popLsb(Bitboard& bb) {
+        int square = lsb(bb);
+        bb &= bb - 1;
+        return square;
+    }
+}
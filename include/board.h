@@ -4,6 +4,8 @@
 #include <string>
 #include <vector>
 #include <cstdint>
+#include "bitboard.h"
+#include "psqt.h"
 
 // The Board class models the chessboard and manages its state and operations.
 // This implementation is designed for extensibility and clarity, suitable for a chess engine aiming at 1500 ELO.
@@ -33,6 +35,25 @@ public:
         NO_COLOUR = 2
     };
 
+    // Castling right flags, combined into a 4-bit mask (bit order matches getCastlingRights)
+    enum CastlingRight : uint8_t {
+        WHITE_KINGSIDE  = 1,
+        WHITE_QUEENSIDE = 2,
+        BLACK_KINGSIDE  = 4,
+        BLACK_QUEENSIDE = 8,
+        ALL_CASTLING    = 15
+    };
+
+    // Reasons tryMove rejects a move; the board prints nothing, so callers report these as they see fit
+    enum MoveError : uint8_t {
+        MOVE_OK = 0,
+        MOVE_BAD_NOTATION,       // Not of the form "e2e4" / "e7e8q"
+        MOVE_NO_PIECE,           // No piece of the side to move on the source square
+        MOVE_ILLEGAL_CASTLE,     // Castling not allowed: rights lost, squares between occupied, or king in or passing through check
+        MOVE_ILLEGAL_EN_PASSANT, // En passant capture not available, or it would expose the king
+        MOVE_ILLEGAL             // Any other move that is not legal in the position
+    };
+
     // Structure representing a square on the board (piece and colour)
     struct Square {
         Piece piece;
@@ -50,10 +71,56 @@ public:
         bool isCastle;        // True if this move is a castling move
         bool isEnPassant;     // True if this move is an en passant capture
 
-        Move(int f, int t, Piece promo = EMPTY, bool castle = false, bool ep = false)
+        Move() = default; // Uninitialised, so move lists can reserve storage cheaply
+        constexpr Move(int f, int t, Piece promo = EMPTY, bool castle = false, bool ep = false)
             : from(f), to(t), promotion(promo), isCastle(castle), isEnPassant(ep) {}
     };
 
+    // A move packed into 16 bits, for tables that store many moves (transposition table, killers, PVs).
+    // Layout: from square (bits 0-5), to square (bits 6-11), flags (bits 12-15):
+    // 1 = castle, 2 = en passant, 4-7 = promotion to knight, bishop, rook or queen.
+    // The all-zero value (a1a1) stands for "no move".
+    class PackedMove {
+    public:
+        static constexpr uint16_t FLAG_CASTLE = 1;
+        static constexpr uint16_t FLAG_EN_PASSANT = 2;
+        static constexpr uint16_t FLAG_PROMOTION = 4;
+
+        constexpr PackedMove() : data(0) {}
+        constexpr explicit PackedMove(uint16_t raw) : data(raw) {}
+
+        // Packs a full move.
+        constexpr explicit PackedMove(const Move& move) : data(static_cast<uint16_t>(
+            move.from | (move.to << 6) | (flagsFor(move) << 12))) {}
+
+        // Unpacks to the full move structure.
+        constexpr Move unpack() const {
+            return Move(from(), to(), promotion(), flags() == FLAG_CASTLE, flags() == FLAG_EN_PASSANT);
+        }
+
+        constexpr int from() const { return data & 0x3F; }
+        constexpr int to() const { return (data >> 6) & 0x3F; }
+        constexpr int flags() const { return data >> 12; }
+        constexpr Piece promotion() const {
+            return (flags() & FLAG_PROMOTION) ? static_cast<Piece>(KNIGHT + (flags() - FLAG_PROMOTION)) : EMPTY;
+        }
+        constexpr uint16_t raw() const { return data; }
+        constexpr bool isNone() const { return data == 0; }
+
+        constexpr bool operator==(const PackedMove& other) const { return data == other.data; }
+        constexpr bool operator!=(const PackedMove& other) const { return data != other.data; }
+
+    private:
+        uint16_t data;
+
+        static constexpr uint16_t flagsFor(const Move& move) {
+            return move.isCastle ? FLAG_CASTLE
+                 : move.isEnPassant ? FLAG_EN_PASSANT
+                 : (move.promotion != EMPTY) ? static_cast<uint16_t>(FLAG_PROMOTION + (move.promotion - KNIGHT))
+                 : 0;
+        }
+    };
+
     // Constructor: initialises the board
     Board();
 
@@ -63,12 +130,21 @@ public:
     // Prints the board in a human-readable format
     void display() const;
 
-    // Applies a move (as a Move struct)
-    // Returns true if the move is successfully applied
-    bool makeMove(const Move& move);
+    // Applies a move without any checks. The move must come from the move generator for this position;
+    // this is the path the search and perft use at every node.
+    void makeMove(const Move& move);
+
+    // Checks that a move from outside the engine (a GUI or the user) is one of the legal moves, then applies it.
+    // Returns MOVE_OK on success; on failure the board is left untouched.
+    MoveError tryMove(const Move& move);
 
-    // Applies a move given in algebraic notation ("e2e4")
-    bool makeMove(const std::string& moveStr);
+    // Same as above, for a move given in algebraic notation ("e2e4")
+    MoveError tryMove(const std::string& moveStr);
+
+    // Takes back the most recent move applied by makeMove, restoring the previous position exactly.
+    // The move passed in must be the one that was made; state it cannot recover
+    // (captured piece, castling rights, en passant square, halfmove clock) comes from the history stack.
+    void unmakeMove(const Move& move);
 
     // Checks if the game is over (checkmate, stalemate, etc.)
     bool isGameOver() const;
@@ -94,15 +170,52 @@ public:
     // Get en passant target square (-1 if none)
     int getEnPassantSquare() const;
 
+    // Bitboard accessors. These are kept in sync with the square array by every board update,
+    // so other modules can loop over pieces or test occupancy without scanning all 64 squares.
+    // Defined inline as they are called at every node of move generation, search and evaluation.
+
+    // Bitboard of all pieces of the given type and colour
+    Bitboard getPieces(Colour colour, Piece piece) const { return pieceBB[colour][piece]; }
+
+    // Bitboard of every piece belonging to the given colour
+    Bitboard getColourPieces(Colour colour) const { return colourBB[colour]; }
+
+    // Bitboard of every occupied square
+    Bitboard getOccupancy() const { return occupiedBB; }
+
+    // Every piece of either colour attacking the square, with sliders blocked by the given occupancy
+    // (pass getOccupancy() for the current position, or a modified set to look through or past pieces).
+    // Intersect with getColourPieces() for one side's attackers.
+    Bitboard attackersTo(int square, Bitboard occupancy) const;
+
+    // 64-bit Zobrist hash of the position (pieces, side to move, castling rights and en passant file).
+    // Maintained incrementally by makeMove and restored by unmakeMove, so reading it is free.
+    uint64_t hash() const { return hashKey; }
+
+    // Zobrist hash of the pawns alone (the XOR of their piece keys), for the pawn-structure cache.
+    // Maintained incrementally alongside hash().
+    uint64_t pawnKey() const { return pawnHashKey; }
+
+    // Material plus piece-square score of the position as a packed middlegame/endgame pair
+    // (positive favours White; see psqt.h).
+    // The piece helpers add and subtract table entries as pieces come and go; unmaking a move reverses them exactly.
+    PSQT::Score psqtScore() const { return psqtValue; }
+
 private:
     // The board is represented as an array of 64 squares
     std::array<Square, NUM_SQUARES> squares;
 
+    // Bitboards mirroring the square array: one per colour and piece type (indexed [colour][piece],
+    // the EMPTY slot is unused), one per colour, and one for all occupied squares.
+    std::array<std::array<Bitboard, 7>, 2> pieceBB;
+    std::array<Bitboard, 2> colourBB;
+    Bitboard occupiedBB;
+
     // Tracks whose turn it is
     Colour sideToMove;
 
-    // Castling rights: [white kingside, white queenside, black kingside, black queenside]
-    std::array<bool, 4> castlingRights;
+    // Castling rights as a mask of CastlingRight flags
+    uint8_t castlingRights;
 
     // En passant target square index (-1 if none)
     int enPassantSquare;
@@ -113,9 +226,42 @@ private:
     // Fullmove number (increments after Black's move)
     int fullmoveNumber;
 
+    // Zobrist hash of the current position
+    uint64_t hashKey;
+
+    // Zobrist hash of the pawns only
+    uint64_t pawnHashKey;
+
+    // Running material and piece-square score (White minus Black), packed middlegame/endgame pair
+    PSQT::Score psqtValue;
+
+    // State saved by makeMove before each move so that unmakeMove can restore it.
+    // Kept small so that pushing and popping it per node is cheap.
+    struct UndoState {
+        uint64_t hash;           // Zobrist hash before the move
+        Square captured;         // Piece captured by the move (EMPTY if none)
+        uint8_t castlingRights;  // Castling rights before the move
+        int8_t enPassantSquare;  // En passant square before the move (-1 if none)
+        uint16_t halfmoveClock;  // Halfmove clock before the move
+    };
+
+    // History of undo states, one per move made (most recent at the back)
+    std::vector<UndoState> history;
+
     // Helper: initialises pieces in their starting positions
     void initialisePosition();
 
+    // Helper: empties every square and bitboard
+    void clearBoard();
+
+    // Helper: computes the Zobrist hash from scratch (used after setting up a position)
+    uint64_t computeHash() const;
+
+    // Helpers: place, remove and move pieces, keeping the square array, bitboards, hashes and piece-square score in sync
+    void putPiece(int square, Piece piece, Colour colour);
+    void removePiece(int square);
+    void movePiece(int from, int to);
+
     // Helper: parses algebraic move notation to indices and flags
     bool parseMove(const std::string& moveStr, Move& move) const;
 
@@ -125,12 +271,6 @@ private:
     // Helper: updates castling rights if king or rook moves
     void updateCastlingRights(const Move& move);
 
-    // Helper: checks if castling move is legal (conditions met)
-    bool isLegalCastle(const Move& move) const;
-
-    // Helper: checks if en passant move is legal (conditions met)
-    bool isLegalEnPassant(const Move& move) const;
-
     // Helper: checks if a square is attacked by the specified colour
     bool isSquareAttacked(int square, Colour attacker) const;
 };
@@ -1,52 +1,93 @@
 #pragma once
 
 #include "board.h"
+#include "psqt.h"
 #include <cstdint>
+#include <vector>
 
 // The Evaluate class provides static methods to assess the quality of a chess position.
 // This is a basic yet extensible evaluation framework suitable for an engine aiming for 1500 Elo.
-// It includes material evaluation, simple piece-square tables, and basic positional considerations.
+// It includes material evaluation, middlegame and endgame piece-square tables blended by game phase (see psqt.h),
+// a cached pawn-structure evaluation, and basic positional considerations.
 // All code is commented in UK English for clarity and future development.
 
 class Evaluate {
 public:
+    // Pawn-structure evaluation of one pawn formation, cached under the board's pawn key.
+    // The score covers doubled, isolated, backward, connected and passed pawns; the masks are kept
+    // for the terms that also depend on other pieces and so cannot be cached.
+    struct PawnEntry {
+        uint64_t key = ~0ULL;           // Pawn key of the formation (~0 marks an unused entry)
+        PSQT::Score score = 0;          // Middlegame/endgame pair, positive favours White
+        Bitboard passed[2] = {};        // Passed pawns of each colour
+        Bitboard semiOpenFiles[2] = {}; // Whole files holding no pawn of the given colour
+    };
+
+    // Pawn hash table, indexed by the low bits of the pawn key. Each search thread owns one (see Search::ThreadData)
+    // and keeps it from move to move; it is allocated on first use.
+    using PawnTable = std::vector<PawnEntry>;
+
     // Evaluates the board position and returns a score (positive for White, negative for Black).
     // Units are centipawns (1 pawn = 100).
+    // The first form evaluates the pawn structure from scratch; the second looks it up in the given pawn table.
     static int score(const Board& board);
-
-private:
-    // Material values for each piece type; can be tuned for engine strength.
-    static constexpr int PAWN_VALUE   = 100;
-    static constexpr int KNIGHT_VALUE = 320;
-    static constexpr int BISHOP_VALUE = 330;
-    static constexpr int ROOK_VALUE   = 500;
-    static constexpr int QUEEN_VALUE  = 900;
-    static constexpr int KING_VALUE   = 0; // King is invaluable (no material value).
-
-    // Piece-square tables for basic positional evaluation.
-    // These tables give small bonuses for piece placement.
-    static const int pawnTable[64];
-    static const int knightTable[64];
-    static const int bishopTable[64];
-    static const int rookTable[64];
-    static const int queenTable[64];
-    static const int kingTable[64];
+    static int score(const Board& board, PawnTable& pawnTable);
 
     // Helper: Returns material score for a given piece type.
     static int getMaterialValue(Board::Piece piece);
 
-    // Helper: Returns piece-square table value for a given piece, square, and colour.
-    static int getPieceSquareValue(Board::Piece piece, int square, Board::Colour colour);
-
+private:
     // Helper: Evaluates castling rights (bonus for retaining ability to castle).
     static int evaluateCastling(const Board& board);
 
-    // Helper: Evaluates pawn structure (basic doubled pawn penalty).
-    static int evaluatePawnStructure(const Board& board);
+    // Entries in each pawn table (a power of two). Pawn structures change rarely during a search,
+    // so a small table is enough for a high hit rate.
+    static constexpr size_t PAWN_TABLE_SIZE = 8192;
+
+    // Pawn-structure term weights (middlegame, endgame), charged per pawn
+    static constexpr PSQT::Score DOUBLED_PAWN   = PSQT::makeScore(-10, -20);
+    static constexpr PSQT::Score ISOLATED_PAWN  = PSQT::makeScore(-10, -15);
+    static constexpr PSQT::Score BACKWARD_PAWN  = PSQT::makeScore(-8, -10);
+    static constexpr PSQT::Score CONNECTED_PAWN = PSQT::makeScore(5, 5);
+    static constexpr int PASSED_PAWN_MG[8] = { 0, 0, 5, 10, 20, 35, 55, 0 }; // Indexed by rank from the pawn's side
+    static constexpr int PASSED_PAWN_EG[8] = { 0, 5, 10, 20, 35, 60, 90, 0 };
+
+    // Weights for rooks on files without pawns, and for passed pawns whose next square is empty
+    static constexpr PSQT::Score ROOK_OPEN_FILE      = PSQT::makeScore(20, 10);
+    static constexpr PSQT::Score ROOK_SEMI_OPEN_FILE = PSQT::makeScore(10, 5);
+    static constexpr PSQT::Score FREE_PASSED_PAWN    = PSQT::makeScore(0, 10);
+
+    // Helper: Returns the pawn-structure entry for the position, from the pawn table or freshly computed.
+    static const PawnEntry& probePawnTable(const Board& board, PawnTable& pawnTable);
 
-    // Helper: Evaluates mobility (number of legal moves).
+    // Helper: Combines every term, given the position's pawn-structure entry.
+    static int score(const Board& board, const PawnEntry& pawns);
+
+    // Helper: Evaluates the pawn structure from scratch into an entry.
+    static void evaluatePawnStructure(const Board& board, PawnEntry& entry);
+
+    // Helper: Evaluates one side's pawns, filling in its passed pawns and semi-open files.
+    static PSQT::Score evaluatePawns(const Board& board, Board::Colour colour, PawnEntry& entry);
+
+    // Helper: Evaluates the terms built on the cached pawn masks: rooks on open and semi-open files,
+    // and passed pawns free to advance.
+    static PSQT::Score evaluatePawnMasks(const Board& board, const PawnEntry& entry);
+
+    // Centipawns per reachable square for each piece type (pawns and kings are not counted).
+    static constexpr int MOBILITY_WEIGHT[7] = { 0, 0, 4, 3, 2, 1, 0 };
+
+    // Helper: Evaluates mobility from the attack sets of the knights, bishops, rooks and queens.
     static int evaluateMobility(const Board& board);
 
+    // Helper: Counts one side's weighted mobility, skipping squares it occupies or the enemy pawns attack.
+    static int sideMobility(const Board& board, Board::Colour colour);
+
+    // Helper: Returns every square attacked by the given pawns.
+    static Bitboard pawnAttacks(Bitboard pawns, Board::Colour colour);
+
+    // Helper: Returns the game phase, from PSQT::MAX_PHASE (opening) down to 0 (pawn endgame).
+    static int gamePhase(const Board& board);
+
     // Helper: Evaluates checkmate and stalemate (large score for winning/losing/drawing positions).
     static int evaluateGameStatus(const Board& board);
 };
@@ -1,7 +1,7 @@
 #pragma once
 
 #include "board.h"
-#include <vector>
+#include "movelist.h"
 #include <string>
 
 // The MoveGen class is responsible for generating all moves (pseudo-legal and legal)
@@ -13,35 +13,57 @@ class MoveGen {
 public:
     // Generates all pseudo-legal moves for the current board position.
     // These moves may include some that leave the king in check.
-    static std::vector<Board::Move> generatePseudoLegalMoves(const Board& board);
+    static MoveList generatePseudoLegalMoves(const Board& board);
 
     // Generates only legal moves for the current board position (moves that do not leave the king in check).
-    static std::vector<Board::Move> generateLegalMoves(const Board& board);
+    static MoveList generateLegalMoves(const Board& board);
+
+    // Generates legal captures (including en passant) and promotions only, for quiescence search.
+    // Quiet moves are never produced.
+    static MoveList generateLegalCaptures(const Board& board);
 
     // Utility function to convert a Move structure to algebraic notation ("e2e4", "e7e8q", etc.).
     static std::string moveToString(const Board::Move& move);
+    static std::string moveToString(Board::PackedMove move) { return moveToString(move.unpack()); }
 
     // Checks if a given move is legal in the current position.
     static bool isLegalMove(const Board& board, const Board::Move& move);
 
+    // Utility to check if a given square is attacked by the opponent (used for legal move filtering and castling).
+    static bool isSquareAttacked(const Board& board, int square, Board::Colour attacker);
+
+    // Utility to find the king's square for a given colour.
+    static int findKingSquare(const Board& board, Board::Colour colour);
+
 private:
     // Helper functions for each piece type, making it easy to extend or modify move generation.
-    static void addPawnMoves(const Board& board, int from, std::vector<Board::Move>& moves);
-    static void addKnightMoves(const Board& board, int from, std::vector<Board::Move>& moves);
-    static void addBishopMoves(const Board& board, int from, std::vector<Board::Move>& moves);
-    static void addRookMoves(const Board& board, int from, std::vector<Board::Move>& moves);
-    static void addQueenMoves(const Board& board, int from, std::vector<Board::Move>& moves);
-    static void addKingMoves(const Board& board, int from, std::vector<Board::Move>& moves);
+    // `targets` limits the destination squares: every square not holding a friendly piece for full
+    // generation, or only enemy-occupied squares for capture generation.
+    // Pawns check emptiness and captures themselves, so they take `allowed` (the check and pin restriction)
+    // and a flag that limits pushes to promotions.
+    // Knights and kings need only their attack table and the targets, so they take no board.
+    static void addPawnMoves(const Board& board, int from, MoveList& moves, Bitboard allowed, bool capturesOnly);
+    static void addKnightMoves(int from, MoveList& moves, Bitboard targets);
+    static void addBishopMoves(const Board& board, int from, MoveList& moves, Bitboard targets);
+    static void addRookMoves(const Board& board, int from, MoveList& moves, Bitboard targets);
+    static void addQueenMoves(const Board& board, int from, MoveList& moves, Bitboard targets);
+    static void addKingMoves(int from, MoveList& moves, Bitboard targets);
 
-    // Helper to add castling moves for the current side if legal.
-    static void addCastlingMoves(const Board& board, std::vector<Board::Move>& moves);
+    // Helper: adds each move for one piece type of the side to move, limited to the given targets.
+    static void addPieceMoves(const Board& board, MoveList& moves, Bitboard targets);
 
-    // Helper to add en passant capture moves if available.
-    static void addEnPassantMoves(const Board& board, std::vector<Board::Move>& moves);
+    // Helper: generates strictly legal moves (or captures and promotions only) from the checkers and pins.
+    static void generateLegal(const Board& board, MoveList& moves, bool capturesOnly);
 
-    // Utility to check if a given square is attacked by the opponent (used for legal move filtering and castling).
-    static bool isSquareAttacked(const Board& board, int square, Board::Colour attacker);
+    // Helper: returns the side's pieces that are pinned to its king.
+    static Bitboard pinnedPieces(const Board& board, Board::Colour side, int kingSq);
 
-    // Utility to find the king's square for a given colour.
-    static int findKingSquare(const Board& board, Board::Colour colour);
+    // Helper: checks that an en passant capture does not expose the king (including along the rank).
+    static bool enPassantIsLegal(const Board& board, const Board::Move& move, int kingSq);
+
+    // Helper to add castling moves for the current side if legal.
+    static void addCastlingMoves(const Board& board, MoveList& moves);
+
+    // Helper to add en passant capture moves if available.
+    static void addEnPassantMoves(const Board& board, MoveList& moves);
 };
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "board.h"
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+
+// The MoveList class holds the moves of one position in fixed inline storage.
+// No chess position has more than 218 legal moves (and pseudo-legal lists stay well below 256),
+// so a list of 256 never overflows; debug builds assert this on every insertion.
+// It lives on the stack of the function that generates it and costs no heap allocation,
+// which matters because the search and perft create one at every node.
+// The storage is left uninitialised; only the first size() moves are ever read.
+// The interface mirrors the parts of std::vector that the engine uses, so range-for loops and
+// standard algorithms work unchanged.
+
+class MoveList {
+public:
+    static constexpr size_t MAX_MOVES = 256;
+
+    void push_back(const Board::Move& move) {
+        assert(count < MAX_MOVES);
+        moves[count++] = move;
+    }
+
+    template <typename... Args>
+    void emplace_back(Args&&... args) {
+        assert(count < MAX_MOVES);
+        moves[count++] = Board::Move(std::forward<Args>(args)...);
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    void clear() { count = 0; }
+
+    // Shortens the list to its first n moves.
+    void resize(size_t n) { count = n; }
+
+    Board::Move& operator[](size_t i) { return moves[i]; }
+    const Board::Move& operator[](size_t i) const { return moves[i]; }
+    Board::Move& front() { return moves[0]; }
+    const Board::Move& front() const { return moves[0]; }
+
+    Board::Move* begin() { return moves.data(); }
+    Board::Move* end() { return moves.data() + count; }
+    const Board::Move* begin() const { return moves.data(); }
+    const Board::Move* end() const { return moves.data() + count; }
+
+private:
+    std::array<Board::Move, MAX_MOVES> moves;
+    size_t count = 0;
+};
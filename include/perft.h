@@ -2,6 +2,8 @@
 
 #include "board.h"
 #include "movegen.h"
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
@@ -14,7 +16,15 @@ class Perft {
 public:
     // Runs a perft test from the given board position to the specified depth.
     // Returns the number of leaf nodes (unique positions) found.
-    static uint64_t run(const Board& board, int depth);
+    // With hashMegabytes > 0, subtree counts are cached by position and depth so that transpositions
+    // are only counted once (see HashTable below).
+    static uint64_t run(const Board& board, int depth, size_t hashMegabytes = 0);
+
+    // Runs the same count on a work-stealing thread pool. The tree is split at depth 2 (every reply to
+    // every root move becomes one task) for an even spread of work, or at the root for shallow depths.
+    // Each worker sums its own leaves and the per-worker totals are added at the end.
+    // The optional hash table is shared by all workers.
+    static uint64_t runParallel(const Board& board, int depth, int threads, size_t hashMegabytes = 0);
 
     // Runs a perft test and gives a breakdown of move types (captures, promotions, castles, en passant, checks).
     // Useful for in-depth debugging and engine validation.
@@ -30,8 +40,40 @@ public:
     static Results runDetailed(const Board& board, int depth);
 
 private:
-    // Helper function for recursive perft counting
-    static void perftRecursive(Board& board, int depth, uint64_t& nodes);
+    // Cache of subtree node counts keyed by Zobrist hash and remaining depth.
+    // Like the search's transposition table it is lock-free: each slot holds (key XOR data) and data
+    // as two relaxed atomic words, so a torn write from another thread just reads as a miss and the
+    // table can be shared by the parallel perft workers. Each 32-byte bucket has a depth-preferred slot,
+    // which keeps the most expensive subtree seen, and an always-replace slot for recent positions.
+    class HashTable {
+    public:
+        explicit HashTable(size_t megabytes);
+
+        // Returns true and sets `nodes` if the count for this position and depth is cached.
+        bool probe(uint64_t key, int depth, uint64_t& nodes) const;
+
+        // Caches a subtree count.
+        void store(uint64_t key, int depth, uint64_t nodes);
+
+    private:
+        // Data word: node count in the low 56 bits, depth in the top 8
+        struct Slot {
+            std::atomic<uint64_t> keyXorData{0};
+            std::atomic<uint64_t> data{0};
+        };
+        struct Bucket {
+            Slot slots[2]; // [0] depth-preferred, [1] always replace
+        };
+
+        std::vector<Bucket> buckets;
+        uint64_t bucketMask = 0;
+
+        static uint64_t pack(int depth, uint64_t nodes) { return (static_cast<uint64_t>(depth) << 56) | nodes; }
+        static int depthOf(uint64_t data) { return static_cast<int>(data >> 56); }
+    };
+
+    // Helper function for recursive perft counting (table may be null)
+    static void perftRecursive(Board& board, int depth, uint64_t& nodes, HashTable* table = nullptr);
 
     // Helper for detailed perft (counts move types)
     static void perftRecursiveDetailed(Board& board, int depth, Results& results);
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <cstdint>
+
+// The PSQT namespace holds the material values and piece-square tables used by the evaluation,
+// folded into one signed score per (colour, piece, square): material plus placement bonus,
+// positive for White and negative for Black.
+// Every entry carries two values, one for the middlegame and one for the endgame, packed into a single
+// 32-bit Score. Board adds and subtracts these entries as pieces are placed, removed and moved, so both
+// halves are kept up to date with one integer addition, and the evaluation blends them by game phase.
+// Like the Zobrist keys, the combined table is built at compile time.
+
+namespace PSQT {
+
+    // A middlegame value in the low 16 bits and an endgame value in the high 16 bits.
+    // Scores add and subtract as plain integers: a negative middlegame half borrows from the endgame half,
+    // and egValue() rounds to undo the borrow.
+    using Score = int32_t;
+
+    constexpr Score makeScore(int mg, int eg) {
+        return static_cast<Score>(static_cast<uint32_t>(eg) << 16) + mg;
+    }
+    constexpr int mgValue(Score score) {
+        return static_cast<int16_t>(static_cast<uint16_t>(static_cast<uint32_t>(score)));
+    }
+    constexpr int egValue(Score score) {
+        return static_cast<int16_t>(static_cast<uint16_t>((static_cast<uint32_t>(score) + 0x8000) >> 16));
+    }
+
+    // Game phase: each piece's weight, and the total with all pieces on the board (the middlegame end).
+    // Pawns and kings do not count; a bare-kings-and-pawns position is phase 0 (pure endgame).
+    constexpr int PHASE_WEIGHT[7] = { 0, 0, 1, 1, 2, 4, 0 };
+    constexpr int MAX_PHASE = 24;
+
+    // Middlegame material values in centipawns, indexed by piece type (EMPTY, PAWN, ..., KING).
+    // These are also the values the search uses for move ordering and delta pruning.
+    // The king is invaluable, so it has no material value.
+    constexpr int PIECE_VALUE[7] = { 0, 100, 320, 330, 500, 900, 0 };
+
+    // Endgame material. Pawns and the major pieces gain with fewer pieces about, the knight loses a little.
+    constexpr int PIECE_VALUE_EG[7] = { 0, 120, 300, 330, 530, 950, 0 };
+
+    // Piece-square tables (values in centipawns), laid out as seen from White's side:
+    // the first row is the eighth rank. Black reads them flipped vertically.
+    // These are the middlegame tables; the endgame ones follow.
+    constexpr int pawnTable[64] = {
+          0,  0,  0,  0,  0,  0,  0,  0,
+         10, 10, 10, 10, 10, 10, 10, 10,
+          5,  5,  8, 12, 12,  8,  5,  5,
+          2,  2,  4, 10, 10,  4,  2,  2,
+          1,  1,  2,  5,  5,  2,  1,  1,
+          0,  0,  0,  0,  0,  0,  0,  0,
+          0,  0,  0, -2, -2,  0,  0,  0,
+          0,  0,  0,  0,  0,  0,  0,  0
+    };
+    constexpr int knightTable[64] = {
+        -50,-40,-30,-30,-30,-30,-40,-50,
+        -40,-20,  0,  0,  0,  0,-20,-40,
+        -30,  0, 10, 15, 15, 10,  0,-30,
+        -30,  5, 15, 20, 20, 15,  5,-30,
+        -30,  0, 15, 20, 20, 15,  0,-30,
+        -30,  5, 10, 15, 15, 10,  5,-30,
+        -40,-20,  0,  5,  5,  0,-20,-40,
+        -50,-40,-30,-30,-30,-30,-40,-50
+    };
+    constexpr int bishopTable[64] = {
+        -20,-10,-10,-10,-10,-10,-10,-20,
+        -10,  5,  0,  0,  0,  0,  5,-10,
+        -10, 10, 10, 10, 10, 10, 10,-10,
+        -10,  0, 10, 10, 10, 10,  0,-10,
+        -10,  5,  5, 10, 10,  5,  5,-10,
+        -10,  0,  5, 10, 10,  5,  0,-10,
+        -10,  0,  0,  0,  0,  0,  0,-10,
+        -20,-10,-10,-10,-10,-10,-10,-20
+    };
+    constexpr int rookTable[64] = {
+         0,  0,  5, 10, 10,  5,  0,  0,
+        -5,  0,  0,  0,  0,  0,  0, -5,
+        -5,  0,  0,  0,  0,  0,  0, -5,
+        -5,  0,  0,  0,  0,  0,  0, -5,
+        -5,  0,  0,  0,  0,  0,  0, -5,
+        -5,  0,  0,  0,  0,  0,  0, -5,
+         5, 10, 10, 10, 10, 10, 10,  5,
+         0,  0,  0,  0,  0,  0,  0,  0
+    };
+    constexpr int queenTable[64] = {
+        -20,-10,-10, -5, -5,-10,-10,-20,
+        -10,  0,  0,  0,  0,  0,  0,-10,
+        -10,  0,  5,  5,  5,  5,  0,-10,
+         -5,  0,  5,  5,  5,  5,  0, -5,
+          0,  0,  5,  5,  5,  5,  0, -5,
+        -10,  5,  5,  5,  5,  5,  0,-10,
+        -10,  0,  5,  0,  0,  0,  0,-10,
+        -20,-10,-10, -5, -5,-10,-10,-20
+    };
+    constexpr int kingTable[64] = {
+        -30,-40,-40,-50,-50,-40,-40,-30,
+        -30,-40,-40,-50,-50,-40,-40,-30,
+        -30,-40,-40,-50,-50,-40,-40,-30,
+        -30,-40,-40,-50,-50,-40,-40,-30,
+        -20,-30,-30,-40,-40,-30,-30,-20,
+        -10,-20,-20,-20,-20,-20,-20,-10,
+         20, 20,  0,  0,  0,  0, 20, 20,
+         20, 30, 10,  0,  0, 10, 30, 20
+    };
+
+    // Endgame tables. The king heads for the centre and pawns are worth more the further they have run.
+    // Knights, bishops and queens are rewarded for centralisation alone, as there is no king to attack
+    // or shelter; rooks keep only their seventh-rank bonus.
+    constexpr int pawnEndgameTable[64] = {
+          0,  0,  0,  0,  0,  0,  0,  0,
+         50, 50, 50, 50, 50, 50, 50, 50,
+         30, 30, 30, 30, 30, 30, 30, 30,
+         20, 20, 20, 20, 20, 20, 20, 20,
+         10, 10, 10, 10, 10, 10, 10, 10,
+          5,  5,  5,  5,  5,  5,  5,  5,
+          0,  0,  0,  0,  0,  0,  0,  0,
+          0,  0,  0,  0,  0,  0,  0,  0
+    };
+    constexpr int knightEndgameTable[64] = {
+        -50,-40,-30,-30,-30,-30,-40,-50,
+        -40,-20,-10, -5, -5,-10,-20,-40,
+        -30,-10, 10, 15, 15, 10,-10,-30,
+        -30, -5, 15, 20, 20, 15, -5,-30,
+        -30, -5, 15, 20, 20, 15, -5,-30,
+        -30,-10, 10, 15, 15, 10,-10,-30,
+        -40,-20,-10, -5, -5,-10,-20,-40,
+        -50,-40,-30,-30,-30,-30,-40,-50
+    };
+    constexpr int bishopEndgameTable[64] = {
+        -15,-10, -8, -5, -5, -8,-10,-15,
+        -10, -5,  0,  2,  2,  0, -5,-10,
+         -8,  0,  5,  8,  8,  5,  0, -8,
+         -5,  2,  8, 12, 12,  8,  2, -5,
+         -5,  2,  8, 12, 12,  8,  2, -5,
+         -8,  0,  5,  8,  8,  5,  0, -8,
+        -10, -5,  0,  2,  2,  0, -5,-10,
+        -15,-10, -8, -5, -5, -8,-10,-15
+    };
+    constexpr int rookEndgameTable[64] = {
+          5,  5,  5,  5,  5,  5,  5,  5,
+         10, 10, 10, 10, 10, 10, 10, 10,
+          0,  0,  0,  0,  0,  0,  0,  0,
+          0,  0,  0,  0,  0,  0,  0,  0,
+          0,  0,  0,  0,  0,  0,  0,  0,
+          0,  0,  0,  0,  0,  0,  0,  0,
+          0,  0,  0,  0,  0,  0,  0,  0,
+          0,  0,  0,  0,  0,  0,  0,  0
+    };
+    constexpr int queenEndgameTable[64] = {
+        -20,-10,-10, -5, -5,-10,-10,-20,
+        -10,  0,  5,  5,  5,  5,  0,-10,
+        -10,  5, 10, 10, 10, 10,  5,-10,
+         -5,  5, 10, 15, 15, 10,  5, -5,
+         -5,  5, 10, 15, 15, 10,  5, -5,
+        -10,  5, 10, 10, 10, 10,  5,-10,
+        -10,  0,  5,  5,  5,  5,  0,-10,
+        -20,-10,-10, -5, -5,-10,-10,-20
+    };
+    constexpr int kingEndgameTable[64] = {
+        -50,-40,-30,-20,-20,-30,-40,-50,
+        -30,-20,-10,  0,  0,-10,-20,-30,
+        -30,-10, 20, 30, 30, 20,-10,-30,
+        -30,-10, 30, 40, 40, 30,-10,-30,
+        -30,-10, 30, 40, 40, 30,-10,-30,
+        -30,-10, 20, 30, 30, 20,-10,-30,
+        -30,-30,  0,  0,  0,  0,-30,-30,
+        -50,-30,-30,-30,-30,-30,-30,-50
+    };
+
+    struct Table {
+        Score scores[2][7][64]; // Indexed [colour][piece][square]; the EMPTY slot stays zero
+
+        constexpr Table() : scores() {
+            const int* middlegame[7] = { nullptr, pawnTable, knightTable, bishopTable, rookTable, queenTable, kingTable };
+            const int* endgame[7] = { nullptr, pawnEndgameTable, knightEndgameTable, bishopEndgameTable, rookEndgameTable,
+                                       queenEndgameTable, kingEndgameTable };
+            for (int p = 1; p < 7; ++p) {
+                for (int sq = 0; sq < 64; ++sq) {
+                    // The tables start at the eighth rank, so White flips the square and Black reads it directly
+                    int white = sq ^ 56;
+                    scores[0][p][sq] = makeScore(PIECE_VALUE[p] + middlegame[p][white], PIECE_VALUE_EG[p] + endgame[p][white]);
+                    scores[1][p][sq] = -makeScore(PIECE_VALUE[p] + middlegame[p][sq], PIECE_VALUE_EG[p] + endgame[p][sq]);
+                }
+            }
+        }
+    };
+
+    inline constexpr Table table{};
+}
@@ -3,33 +3,146 @@
 #include "board.h"
 #include "movegen.h"
 #include "evaluate.h"
+#include "tt.h"
+#include "timeman.h"
+#include <atomic>
 #include <cstdint>
 #include <vector>
 #include <limits>
+#include <functional>
 
 // The Search class implements the thinking logic of the chess engine.
-// This module searches for the best move using a minimax algorithm with alpha-beta pruning.
+// This module searches for the best move using a negamax principal variation search (alpha-beta
+// where every move after the first is tried with a null window and only re-searched if it fails high).
 // It uses the Evaluate class to score positions and MoveGen for legal moves.
 // The code is designed to be modular and extensible, with thorough UK English comments
 // to help you understand every step and make improvements for higher Elo strengths.
 
 class Search {
 public:
-    // Searches for the best move from the current position.
-    // Returns the best move found and sets its evaluation score.
-    static Board::Move findBestMove(const Board& board, int depth, int& outScore);
+    // Score bounds. All search scores are from the side to move's point of view and stay well inside
+    // int range, so they can always be negated safely. Mate scores are MATE_SCORE minus the distance
+    // to mate in plies, so anything beyond MATE_BOUND is a forced mate.
+    static constexpr int INFINITE_SCORE = 32000;
+    static constexpr int MATE_SCORE = 31000;
+    static constexpr int MAX_PLY = 128;
+    static constexpr int MATE_BOUND = MATE_SCORE - MAX_PLY;
+
+    // Progress report passed to the caller after each completed iteration of iterative deepening.
+    struct SearchInfo {
+        int depth = 0;                           // Depth just completed
+        int score = 0;                           // Score of the best move at that depth (side to move's view)
+        Board::Move bestMove = Board::Move(0, 0); // Best move at that depth
+        uint64_t nodes = 0;                      // Nodes searched so far
+        int timeMs = 0;                          // Time elapsed since the search started
+    };
+
+    // Called after every completed depth (may be empty).
+    using InfoCallback = std::function<void(const SearchInfo&)>;
+
+    // Searches for the best move from the current position using iterative deepening:
+    // depth 1, 2, 3 ... up to the given depth, trying the previous iteration's best move first.
+    // Clock limits end the search early (see TimeManager); an iteration cut short is discarded.
+    // Returns the best move found and sets its score for the side to move. onIteration is called after each depth.
+    static Board::Move findBestMove(const Board& board, int depth, const TimeManager::Limits& limits,
+                                    int& outScore, const InfoCallback& onIteration = nullptr);
+
+    // Fixed-depth search with no clock.
+    static Board::Move findBestMove(const Board& board, int depth, int& outScore,
+                                    const InfoCallback& onIteration = nullptr);
 
     // Returns only the best move (convenience overload).
     static Board::Move findBestMove(const Board& board, int depth);
 
-    // Minimax search with alpha-beta pruning.
-    // Returns the evaluation score for the given position.
-    static int minimax(Board& board, int depth, int alpha, int beta, bool maximisingPlayer);
+    // Upper limit for the UCI "Threads" option
+    static constexpr int MAX_THREADS = 1024;
+
+    // Sets the number of threads (the main thread plus Lazy SMP helpers) used by later searches.
+    static void setThreadCount(int count);
+    static int getThreadCount() { return threadCount; }
+
+    // Controls for a search running on another thread. All three are safe to call from any thread.
+    // resetSignals() must be called before the search is started, so that a "stop" arriving before
+    // the search thread has begun is not lost.
+    static void resetSignals();
+    static void stop();      // Finish as soon as possible, returning the last completed iteration's move
+    static void ponderhit(); // The pondered move was played: apply the time limits from now on
+
+    // Negamax principal variation search.
+    // Returns the score of the given position for the side to move; ply is the distance from the root.
+    static int negamax(Board& board, int depth, int alpha, int beta, int ply);
+
+    // Quiescence search: extends the leaves with captures and promotions until the position is quiet,
+    // so that a leaf is never scored in the middle of an exchange (the horizon effect).
+    // Returns the score for the side to move.
+    static int quiescence(Board& board, int alpha, int beta, int ply);
 
 private:
-    // Helper: Orders moves to improve alpha-beta efficiency (simple MVV/LVA).
-    static std::vector<Board::Move> orderMoves(const Board& board, const std::vector<Board::Move>& moves);
+    // Safety margin for delta pruning in quiescence: a capture is skipped if even winning the captured
+    // piece plus this margin cannot raise the score to alpha.
+    static constexpr int DELTA_MARGIN = 200;
+
+    // The clock is checked once every this many nodes (a power of two, so a mask can be used)
+    static constexpr uint64_t TIME_CHECK_INTERVAL = 2048;
+
+    // State of one search thread. Each sits on its own cache line so node counting does not cause false sharing.
+    struct alignas(64) ThreadData {
+        std::atomic<uint64_t> nodes{0};             // Nodes visited (written by this thread only)
+        bool stopped = false;                       // Set once this thread must abandon its search
+        Board::Move bestMove = Board::Move(0, 0);   // Result of the last completed depth
+        int score = 0;
+        int completedDepth = 0;
+        Evaluate::PawnTable pawnTable;              // Kept across searches while the thread count is unchanged
+    };
+
+    // Deadlines of the current search (used by the main thread only)
+    static TimeManager timeManager;
+
+    // Requests from other threads, polled by the search
+    static std::atomic<bool> stopRequested;
+    static std::atomic<bool> ponderhitRequested;
 
-    // Helper: Checks for game over and returns mate/stalemate scores.
+    // Set by the main thread when it has finished, to stop the helpers
+    static std::atomic<bool> searchFinished;
+
+    // Configured thread count, the state of each thread (index 0 is the main thread) and the calling thread's entry
+    static int threadCount;
+    static std::vector<ThreadData> threads;
+    static thread_local ThreadData* thisThread;
+
+    // Helper: runs iterative deepening on one thread, recording each completed depth in its ThreadData.
+    // Only the main thread (index 0) reports progress and checks the clock.
+    static void iterativeDeepening(Board& root, MoveList moves, int depth, int threadIndex,
+                                   const InfoCallback* onIteration);
+
+    // Helper: picks the move to play from the threads' results by weighted voting.
+    static Board::Move voteBestMove(int& outScore);
+
+    // Helper: sums the node counts of all threads.
+    static uint64_t totalNodes();
+
+    // Helper: counts a node, stopping the search on request; the clock is read every TIME_CHECK_INTERVAL nodes.
+    static void countNode();
+
+    // Helper: applies a pending ponderhit and stops the search if the hard deadline has passed.
+    static void checkTime();
+
+    // Helper: searches every root move to the given depth and returns the best one (with its score).
+    static Board::Move searchRoot(Board& board, const MoveList& moves, int depth, int& outScore);
+
+    // Helper: Orders moves to improve alpha-beta efficiency (hash move first, then simple MVV/LVA).
+    static void orderMoves(const Board& board, MoveList& moves, const Board::Move& ttMove);
+
+    // Helper: Compares two moves by squares and promotion piece.
+    static bool sameMove(const Board::Move& a, const Board::Move& b);
+
+    // Helper: Returns the mate or stalemate score for a position with no legal moves.
     static int checkGameOver(const Board& board, int ply);
+
+    // Helper: Returns the static evaluation from the side to move's point of view.
+    static int evaluateRelative(const Board& board);
+
+    // Helpers: Convert mate scores between "distance from root" (search) and "distance from this node" (TT).
+    static int scoreToTT(int score, int ply);
+    static int scoreFromTT(int score, int ply);
 };
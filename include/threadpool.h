@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// The ThreadPool class runs independent tasks on a fixed set of worker threads.
+// Each worker has its own task queue. Submitted tasks are dealt out round-robin. A worker takes tasks
+// from the back of its own queue and, once that is empty, steals from the front of the other queues,
+// so a worker that was handed quick tasks helps with the slow ones instead of sitting idle.
+// Tasks receive the index of the worker running them, so results can be kept per worker and
+// combined at the end without any locking.
+
+class ThreadPool {
+public:
+    // A unit of work; the argument is the index (0 .. size() - 1) of the worker running it.
+    using Task = std::function<void(int worker)>;
+
+    // Starts the given number of workers (at least one).
+    explicit ThreadPool(int threads);
+
+    // Finishes the queued tasks and joins the workers.
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Queues a task.
+    void submit(Task task);
+
+    // Blocks until every submitted task has finished.
+    void wait();
+
+    // Number of worker threads.
+    int size() const { return static_cast<int>(workers.size()); }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+
+    // Tasks submitted but not yet finished, and tasks still waiting in a queue
+    std::atomic<int> unfinished{0};
+    std::atomic<int> queued{0};
+    std::atomic<int> nextQueue{0};
+    bool quit = false;
+
+    // Wakes idle workers when tasks arrive, and waiters when the last task finishes
+    std::mutex stateMutex;
+    std::condition_variable taskAvailable;
+    std::condition_variable allDone;
+
+    // Helper: the loop each worker runs until the pool is destroyed.
+    void workerLoop(int index);
+
+    // Helper: takes a task from the worker's own queue, or steals one from another queue.
+    bool popTask(int index, Task& task);
+};
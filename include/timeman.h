@@ -0,0 +1,63 @@
+#pragma once
+
+#include "board.h"
+#include <chrono>
+#include <cstdint>
+
+// The TimeManager class decides how long the engine may think about a move.
+// From the clock state sent with the UCI "go" command it computes two deadlines:
+//  - a soft limit, after which no new iteration of iterative deepening is started, and
+//  - a hard limit, at which a running search is abandoned (checked every few thousand nodes).
+// The soft limit is shortened when the best move has stayed the same for several iterations,
+// since further searching is then unlikely to change the decision.
+// While pondering (or in an infinite search) no deadline applies; on "ponderhit" the clock starts.
+
+class TimeManager {
+public:
+    // Clock state from the "go" command, in milliseconds (-1 when not given).
+    struct Limits {
+        int wtime = -1;
+        int btime = -1;
+        int winc = 0;
+        int binc = 0;
+        int movestogo = 0; // Moves until the next time control (0 for sudden death)
+        int movetime = -1; // Exact time to spend on this move
+        bool infinite = false; // Search until told to stop
+        bool ponder = false;   // Searching on the opponent's time: limits apply from ponderhit()
+    };
+
+    // Starts the clock and computes the deadlines for the given side to move.
+    void start(const Limits& limits, Board::Colour side);
+
+    // The opponent played the pondered move: the deadlines now apply, counted from this moment.
+    void ponderhit();
+
+    // Returns true if the search is limited by time at all.
+    bool isActive() const { return active; }
+
+    // Milliseconds since start() was called.
+    int elapsedMs() const;
+
+    // Returns true once the running search must stop immediately.
+    bool hardLimitReached() const { return active && elapsedMs() >= hardLimitMs; }
+
+    // Returns true if no further iteration should be started, given how many consecutive
+    // iterations have returned the same best move.
+    bool softLimitReached(int stableIterations) const;
+
+private:
+    // Time kept in reserve for communication lag between the engine and the GUI
+    static constexpr int MOVE_OVERHEAD_MS = 30;
+    // Moves assumed to remain in the game when the time control does not say
+    static constexpr int DEFAULT_MOVES_TO_GO = 40;
+    // Consecutive iterations with the same best move after which the soft limit is halved
+    static constexpr int STABLE_ITERATIONS = 4;
+
+    std::chrono::steady_clock::time_point startTime;
+    Limits pendingLimits;  // Limits of a pondering search, applied by ponderhit()
+    Board::Colour pendingSide = Board::WHITE;
+    bool pondering = false;
+    bool active = false;
+    int softLimitMs = 0;
+    int hardLimitMs = 0;
+};
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "board.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// The TranspositionTable class caches search results by Zobrist hash, so that a position reached
+// through a different move order (a transposition) does not have to be searched again.
+//
+// Layout: the table is an array of 64-byte buckets (one cache line each), holding four 16-byte entries.
+// A probe touches a single cache line. When a bucket is full, the entry with the lowest
+// "depth minus age" is replaced, so deep results from the current search are kept and stale ones are recycled.
+//
+// Thread safety: each entry stores (key XOR data) alongside the data, written and read as two relaxed
+// atomic 64-bit words. A torn write from another thread makes the XOR check fail, so the probe simply
+// misses. This lets many search threads share one table without locks.
+
+class TranspositionTable {
+public:
+    // Kind of score stored in an entry
+    enum Bound : uint8_t {
+        BOUND_NONE  = 0,
+        BOUND_UPPER = 1, // Fail-low: the true score is at most the stored score
+        BOUND_LOWER = 2, // Fail-high: the true score is at least the stored score
+        BOUND_EXACT = 3  // Exact score (principal variation node)
+    };
+
+    // Unpacked contents of an entry
+    struct Entry {
+        Board::Move move = Board::Move(0, 0); // Best move found (from == to when there is none)
+        int score = 0;
+        int depth = 0;
+        Bound bound = BOUND_NONE;
+    };
+
+    // Default table size in megabytes
+    static constexpr size_t DEFAULT_SIZE_MB = 16;
+
+    explicit TranspositionTable(size_t megabytes = DEFAULT_SIZE_MB);
+
+    // Reallocates the table to the given size in megabytes (rounded down to a power-of-two bucket count).
+    // Clears all entries. Must not be called while a search is running.
+    // Returns false if the memory could not be allocated, in which case the table keeps its previous size.
+    bool resize(size_t megabytes);
+
+    // Empties every entry.
+    void clear();
+
+    // Starts a new search: bumps the generation so entries from earlier searches age out first.
+    void newSearch();
+
+    // Looks up a position. Returns true and fills `entry` if a verified entry was found.
+    bool probe(uint64_t key, Entry& entry) const;
+
+    // Stores a search result for a position, choosing which entry of the bucket to replace.
+    void store(uint64_t key, const Board::Move& move, int score, int depth, Bound bound);
+
+    // Returns the approximate fill level in permille of entries written during the current search (for UCI "hashfull").
+    int hashfull() const;
+
+private:
+    static constexpr int ENTRIES_PER_BUCKET = 4;
+    static constexpr int GENERATION_BITS = 6;
+    static constexpr uint8_t GENERATION_MASK = (1 << GENERATION_BITS) - 1;
+
+    // A stored entry: the data word packs move (16 bits), score (32 bits), depth (8 bits),
+    // bound (2 bits) and generation (6 bits). keyXorData holds the position key XOR the data word.
+    struct Slot {
+        std::atomic<uint64_t> keyXorData{0};
+        std::atomic<uint64_t> data{0};
+    };
+
+    struct alignas(64) Bucket {
+        Slot slots[ENTRIES_PER_BUCKET];
+    };
+
+    std::vector<Bucket> buckets;
+    uint64_t bucketMask = 0;
+    uint8_t generation = 0;
+
+    // Helpers: bucket selection and data word packing
+    Bucket& bucketFor(uint64_t key) { return buckets[key & bucketMask]; }
+    const Bucket& bucketFor(uint64_t key) const { return buckets[key & bucketMask]; }
+    static uint64_t pack(const Board::Move& move, int score, int depth, Bound bound, uint8_t gen);
+    static Entry unpack(uint64_t data);
+    static int depthOf(uint64_t data) { return static_cast<int8_t>(data >> 48); }
+    static uint8_t generationOf(uint64_t data) { return static_cast<uint8_t>(data >> 58) & GENERATION_MASK; }
+};
+
+// The transposition table shared by every search thread.
+extern TranspositionTable TT;
@@ -1 +1,69 @@
+#pragma once
 
+#include "board.h"
+#include "movegen.h"
+#include "search.h"
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// The UCI class implements the Universal Chess Interface protocol, allowing the engine
+// to communicate with graphical user interfaces and match managers.
+// Each handler corresponds to one UCI command, making it easy to add further commands and options.
+// Detailed UK English comments are provided to explain the protocol flow.
+// The search runs on its own thread, so the input loop keeps reading commands ("stop", "ponderhit",
+// "isready", "quit") while the engine thinks.
+
+class UCI {
+public:
+    // Stops and joins any running search.
+    ~UCI();
+
+    // Starts the UCI command loop (reads from stdin until "quit").
+    void run();
+
+    // Handles a single UCI command line. Returns false once "quit" has been received.
+    bool execute(const std::string& line);
+
+private:
+    // The position the engine is currently analysing.
+    Board board;
+
+    // Worker thread running the current search (joinable while a search is in progress or unjoined).
+    std::thread searchThread;
+
+    // An infinite or pondering search must not report its move until "stop" (or "ponderhit" when
+    // pondering) arrives, even if it finishes first. These flags, guarded by signalMutex, record those commands.
+    std::mutex signalMutex;
+    std::condition_variable signalChanged;
+    bool stopSignal = false;
+    bool ponderSignal = false;
+
+    // Serialises output from the input loop and the search thread, so lines are never interleaved.
+    std::mutex outputMutex;
+
+    // Command handlers.
+    void handleUci();
+    void handleIsReady();
+    void handleUciNewGame();
+    void handleSetOption(const std::vector<std::string>& tokens);
+    void handlePosition(const std::vector<std::string>& tokens);
+    void handleGo(const std::vector<std::string>& tokens);
+    void handleStop();
+    void handlePonderHit();
+    void handleQuit();
+
+    // Helper: stops any running search and waits for its thread to finish.
+    void stopSearch();
+
+    // Helper: applies a list of moves in algebraic notation to the board.
+    void applyMoves(const std::vector<std::string>& moves);
+
+    // Helper: prints an info line (depth, score, time, nodes, hash fill, principal variation) for the GUI.
+    void printInfo(int depth, int score, int timeMs, uint64_t nodes, const std::string& pv);
+
+    // Helper: splits a command line into whitespace-separated tokens.
+    static std::vector<std::string> split(const std::string& s);
+};
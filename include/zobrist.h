@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+
+// The Zobrist namespace holds the random keys used to hash chess positions.
+// A position's hash is the XOR of one key per (colour, piece, square) plus keys for the side to move,
+// the castling rights and the en passant file. Because XOR is its own inverse, Board can update the
+// hash incrementally as pieces move rather than recomputing it.
+// The keys are generated at compile time from a fixed seed, so there is no start-up cost and
+// hashes are identical between runs (useful for debugging and for stored test data).
+
+namespace Zobrist {
+
+    // SplitMix64 step: a small, well-mixed pseudo-random generator usable in constant expressions.
+    constexpr uint64_t splitMix64(uint64_t& state) {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    struct Keys {
+        uint64_t pieces[2][7][64]; // Indexed [colour][piece][square]; the EMPTY slot stays zero
+        uint64_t castling[16];     // Indexed by the castling-rights mask
+        uint64_t enPassant[8];     // Indexed by the en passant file
+        uint64_t sideToMove;       // XORed in when Black is to move
+
+        constexpr Keys() : pieces(), castling(), enPassant(), sideToMove(0) {
+            uint64_t state = 0x4F6C69766961ULL; // Fixed seed
+            for (int c = 0; c < 2; ++c)
+                for (int p = 1; p < 7; ++p)
+                    for (int sq = 0; sq < 64; ++sq)
+                        pieces[c][p][sq] = splitMix64(state);
+
+            // One key per individual right; each mask's key is the XOR of its rights,
+            // so a change of rights is a single XOR of the old and new mask keys.
+            uint64_t rightKeys[4] = {};
+            for (int i = 0; i < 4; ++i)
+                rightKeys[i] = splitMix64(state);
+            for (int mask = 0; mask < 16; ++mask)
+                for (int i = 0; i < 4; ++i)
+                    if (mask & (1 << i))
+                        castling[mask] ^= rightKeys[i];
+
+            for (int f = 0; f < 8; ++f)
+                enPassant[f] = splitMix64(state);
+            sideToMove = splitMix64(state);
+        }
+    };
+
+    inline constexpr Keys keys{};
+}
@@ -0,0 +1,228 @@
+#include "attacks.h"
+#include <vector>
+
+#ifdef OLIVIATHAN_PEXT
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+// Ray directions (file step, rank step) for each slider type
+static const int bishopDirections[4][2] = {
+    {1, 1}, {1, -1}, {-1, -1}, {-1, 1}
+};
+static const int rookDirections[4][2] = {
+    {1, 0}, {0, 1}, {-1, 0}, {0, -1}
+};
+
+Attacks::Magic Attacks::bishopMagics[64];
+Attacks::Magic Attacks::rookMagics[64];
+Bitboard Attacks::bishopTable[0x1480];
+Bitboard Attacks::rookTable[0x19000];
+Attacks::Backend Attacks::backend = Attacks::MAGIC;
+Bitboard Attacks::betweenTable[64][64];
+Bitboard Attacks::lineTable[64][64];
+
+#ifdef OLIVIATHAN_PEXT
+Bitboard* Attacks::bishopPextAttacks[64];
+Bitboard* Attacks::rookPextAttacks[64];
+Bitboard Attacks::bishopPextTable[0x1480];
+Bitboard Attacks::rookPextTable[0x19000];
+
+// Queries CPUID for BMI2. AMD processors before Zen 3 (family 19h) implement PEXT in microcode,
+// where it is far slower than a magic multiply, so they are treated as unsupported.
+static bool detectFastBmi2() {
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) || !(ebx & bit_BMI2))
+        return false;
+    __get_cpuid(0, &eax, &ebx, &ecx, &edx);
+    bool isAmd = (ebx == 0x68747541); // "Auth" of "AuthenticAMD"
+    if (isAmd) {
+        __get_cpuid(1, &eax, &ebx, &ecx, &edx);
+        unsigned family = ((eax >> 8) & 0xF) + ((eax >> 20) & 0xFF);
+        if (family < 0x19)
+            return false;
+    }
+    return true;
+}
+
+// Software equivalent of PEXT, used only while building the tables so that no BMI2
+// instruction runs before the CPU check.
+static unsigned softwarePext(Bitboard value, Bitboard mask) {
+    unsigned result = 0;
+    for (unsigned bit = 0; mask; ++bit) {
+        int sq = Bitboards::popLsb(mask);
+        if (Bitboards::testBit(value, sq))
+            result |= 1u << bit;
+    }
+    return result;
+}
+
+__attribute__((target("bmi2")))
+Bitboard Attacks::bishopAttacksPext(int square, Bitboard occupancy) {
+    return bishopPextAttacks[square][_pext_u64(occupancy, bishopMagics[square].mask)];
+}
+
+__attribute__((target("bmi2")))
+Bitboard Attacks::rookAttacksPext(int square, Bitboard occupancy) {
+    return rookPextAttacks[square][_pext_u64(occupancy, rookMagics[square].mask)];
+}
+
+// Fills a PEXT table: each square's slice is indexed by the relevant blockers packed into the low bits.
+void Attacks::initPext(const Magic magics[], Bitboard* entries[], Bitboard table[], const int directions[4][2]) {
+    Bitboard* slot = table;
+    for (int sq = 0; sq < 64; ++sq) {
+        entries[sq] = slot;
+        Bitboard subset = 0;
+        do {
+            slot[softwarePext(subset, magics[sq].mask)] = slidingAttacks(sq, subset, directions);
+            subset = (subset - magics[sq].mask) & magics[sq].mask;
+        } while (subset);
+        slot += 1ULL << Bitboards::popCount(magics[sq].mask);
+    }
+}
+#endif
+
+// Builds the bishop and rook tables (only the first call does any work) and picks
+// the fastest backend this CPU supports.
+void Attacks::init() {
+    static bool initialised = false;
+    if (initialised) return;
+    initMagics(bishopMagics, bishopTable, bishopDirections);
+    initMagics(rookMagics, rookTable, rookDirections);
+#ifdef OLIVIATHAN_PEXT
+    if (pextSupported()) {
+        initPext(bishopMagics, bishopPextAttacks, bishopPextTable, bishopDirections);
+        initPext(rookMagics, rookPextAttacks, rookPextTable, rookDirections);
+        backend = PEXT;
+    }
+#endif
+    initLines();
+    initialised = true;
+}
+
+// For each aligned pair of squares, the line is the intersection of the two squares' empty-board
+// attacks along that direction, and the squares between are where their attacks meet when each
+// square blocks the other.
+void Attacks::initLines() {
+    for (int a = 0; a < 64; ++a) {
+        for (int b = 0; b < 64; ++b) {
+            betweenTable[a][b] = lineTable[a][b] = 0;
+            if (a == b) continue;
+            Bitboard ends = Bitboards::squareBB(a) | Bitboards::squareBB(b);
+            if (rookAttacks(a, 0) & Bitboards::squareBB(b)) {
+                lineTable[a][b] = (rookAttacks(a, 0) & rookAttacks(b, 0)) | ends;
+                betweenTable[a][b] = rookAttacks(a, Bitboards::squareBB(b)) & rookAttacks(b, Bitboards::squareBB(a));
+            } else if (bishopAttacks(a, 0) & Bitboards::squareBB(b)) {
+                lineTable[a][b] = (bishopAttacks(a, 0) & bishopAttacks(b, 0)) | ends;
+                betweenTable[a][b] = bishopAttacks(a, Bitboards::squareBB(b)) & bishopAttacks(b, Bitboards::squareBB(a));
+            }
+        }
+    }
+}
+
+// Checks whether PEXT was compiled in and the CPU has fast BMI2 (detected once).
+bool Attacks::pextSupported() {
+#ifdef OLIVIATHAN_PEXT
+    static const bool supported = detectFastBmi2();
+    return supported;
+#else
+    return false;
+#endif
+}
+
+// Switches the slider backend, refusing PEXT where it cannot run.
+bool Attacks::setBackend(Backend requested) {
+    if (requested == PEXT && !pextSupported())
+        return false;
+    backend = requested;
+    return true;
+}
+
+// Walks each ray from the square until it leaves the board or hits an occupied square (which is included).
+Bitboard Attacks::slidingAttacks(int square, Bitboard occupancy, const int directions[4][2]) {
+    Bitboard attacks = 0;
+    int file = square % 8;
+    int rank = square / 8;
+    for (int d = 0; d < 4; ++d) {
+        for (int dist = 1; dist < 8; ++dist) {
+            int toFile = file + directions[d][0] * dist;
+            int toRank = rank + directions[d][1] * dist;
+            if (toFile < 0 || toFile >= 8 || toRank < 0 || toRank >= 8)
+                break;
+            int to = toRank * 8 + toFile;
+            attacks |= Bitboards::squareBB(to);
+            if (Bitboards::testBit(occupancy, to))
+                break; // Blocked by any piece
+        }
+    }
+    return attacks;
+}
+
+// Finds a magic number for every square by trial: a random sparse candidate is accepted
+// once every blocker configuration maps to an index that holds the correct attack set.
+// The random generator is reseeded per rank with values known to find magics quickly,
+// so the same magics are found on every run and start-up stays fast.
+void Attacks::initMagics(Magic magics[], Bitboard table[], const int directions[4][2]) {
+    static const uint64_t rankSeeds[8] = { 728, 10316, 55013, 32803, 12281, 15100, 16645, 255 };
+    uint64_t seed = 0;
+    auto random = [&seed]() {
+        // xorshift64* generator
+        seed ^= seed >> 12;
+        seed ^= seed << 25;
+        seed ^= seed >> 27;
+        return seed * 2685821657736338717ULL;
+    };
+
+    std::vector<Bitboard> occupancies(4096), reference(4096);
+    std::vector<int> epoch(4096, 0);
+    int attempt = 0;
+    Bitboard* slot = table;
+
+    for (int sq = 0; sq < 64; ++sq) {
+        Magic& m = magics[sq];
+        seed = rankSeeds[sq / 8];
+
+        // Edge squares never affect the attack set unless the piece is on that edge,
+        // so they are left out of the mask to keep the tables small.
+        int file = sq % 8;
+        int rank = sq / 8;
+        Bitboard edges = ((Bitboards::RANK_1 | Bitboards::RANK_8) & ~Bitboards::rankBB(rank)) |
+                         ((Bitboards::FILE_A | Bitboards::FILE_H) & ~Bitboards::fileBB(file));
+        m.mask = slidingAttacks(sq, 0, directions) & ~edges;
+        int bits = Bitboards::popCount(m.mask);
+        m.shift = 64 - bits;
+        m.attacks = slot;
+        slot += 1ULL << bits;
+
+        // Enumerate every subset of the mask (Carry-Rippler trick) with its true attack set.
+        int size = 0;
+        Bitboard subset = 0;
+        do {
+            occupancies[size] = subset;
+            reference[size] = slidingAttacks(sq, subset, directions);
+            size++;
+            subset = (subset - m.mask) & m.mask;
+        } while (subset);
+
+        // Try candidates until one produces no destructive collisions.
+        bool found = false;
+        while (!found) {
+            do {
+                m.magic = random() & random() & random();
+            } while (Bitboards::popCount((m.mask * m.magic) >> 56) < 6);
+
+            ++attempt;
+            found = true;
+            for (int i = 0; i < size; ++i) {
+                unsigned idx = m.index(occupancies[i]);
+                if (epoch[idx] < attempt) {
+                    epoch[idx] = attempt;
+                    m.attacks[idx] = reference[i];
+                } else if (m.attacks[idx] != reference[i]) {
+                    found = false;
+                    break;
+                }
+            }
+        }
+    }
+}
@@ -1,12 +1,15 @@
 #include "board.h"
+#include "zobrist.h"
+#include "attacks.h"
+#include "movegen.h"
 #include <iostream>
 #include <sstream>
 #include <cctype>
 
 // Constructor: set up a fresh board
 Board::Board()
-    : squares(), sideToMove(WHITE), castlingRights{true, true, true, true},
-      enPassantSquare(-1), halfmoveClock(0), fullmoveNumber(1)
+    : squares(), pieceBB(), colourBB(), occupiedBB(0), sideToMove(WHITE), castlingRights(ALL_CASTLING),
+      enPassantSquare(-1), halfmoveClock(0), fullmoveNumber(1), hashKey(0), pawnHashKey(0), psqtValue(0)
 {
     reset();
 }
@@ -15,29 +18,100 @@ Board::Board()
 void Board::reset() {
     initialisePosition();
     sideToMove = WHITE;
-    castlingRights = {true, true, true, true};
+    castlingRights = ALL_CASTLING;
     enPassantSquare = -1;
     halfmoveClock = 0;
     fullmoveNumber = 1;
+    history.clear();
+    hashKey = computeHash();
 }
 
 // Initialises pieces in their starting positions
 void Board::initialisePosition() {
     // Set all squares to empty
-    for (auto& sq : squares) {
-        sq = Square();
-    }
+    clearBoard();
     // Place pawns
     for (int f = 0; f < BOARD_SIZE; ++f) {
-        squares[toIndex(f, 1)] = Square(PAWN, WHITE);
-        squares[toIndex(f, 6)] = Square(PAWN, BLACK);
+        putPiece(toIndex(f, 1), PAWN, WHITE);
+        putPiece(toIndex(f, 6), PAWN, BLACK);
     }
     // Place major pieces for both sides
     std::array<Piece, BOARD_SIZE> backRank = {ROOK, KNIGHT, BISHOP, QUEEN, KING, BISHOP, KNIGHT, ROOK};
     for (int f = 0; f < BOARD_SIZE; ++f) {
-        squares[toIndex(f, 0)] = Square(backRank[f], WHITE);
-        squares[toIndex(f, 7)] = Square(backRank[f], BLACK);
+        putPiece(toIndex(f, 0), backRank[f], WHITE);
+        putPiece(toIndex(f, 7), backRank[f], BLACK);
+    }
+}
+
+// Empties every square and bitboard
+void Board::clearBoard() {
+    for (auto& sq : squares) {
+        sq = Square();
+    }
+    for (auto& bbs : pieceBB) {
+        bbs.fill(0);
     }
+    colourBB.fill(0);
+    occupiedBB = 0;
+    hashKey = 0;
+    pawnHashKey = 0;
+    psqtValue = 0;
+}
+
+// Computes the Zobrist hash of the current position from scratch
+uint64_t Board::computeHash() const {
+    uint64_t key = 0;
+    for (int sq = 0; sq < NUM_SQUARES; ++sq) {
+        if (squares[sq].piece != EMPTY)
+            key ^= Zobrist::keys.pieces[squares[sq].colour][squares[sq].piece][sq];
+    }
+    key ^= Zobrist::keys.castling[castlingRights];
+    if (enPassantSquare != -1)
+        key ^= Zobrist::keys.enPassant[enPassantSquare % BOARD_SIZE];
+    if (sideToMove == BLACK)
+        key ^= Zobrist::keys.sideToMove;
+    return key;
+}
+
+// Places a piece on an empty square, updating the bitboards, hashes and piece-square score
+void Board::putPiece(int square, Piece piece, Colour colour) {
+    Bitboard bb = Bitboards::squareBB(square);
+    squares[square] = Square(piece, colour);
+    hashKey ^= Zobrist::keys.pieces[colour][piece][square];
+    if (piece == PAWN) pawnHashKey ^= Zobrist::keys.pieces[colour][PAWN][square];
+    psqtValue += PSQT::table.scores[colour][piece][square];
+    pieceBB[colour][piece] |= bb;
+    colourBB[colour] |= bb;
+    occupiedBB |= bb;
+}
+
+// Removes whatever piece stands on a square, updating the bitboards, hashes and piece-square score
+void Board::removePiece(int square) {
+    Square sq = squares[square];
+    if (sq.piece == EMPTY) return;
+    Bitboard bb = Bitboards::squareBB(square);
+    hashKey ^= Zobrist::keys.pieces[sq.colour][sq.piece][square];
+    if (sq.piece == PAWN) pawnHashKey ^= Zobrist::keys.pieces[sq.colour][PAWN][square];
+    psqtValue -= PSQT::table.scores[sq.colour][sq.piece][square];
+    pieceBB[sq.colour][sq.piece] &= ~bb;
+    colourBB[sq.colour] &= ~bb;
+    occupiedBB &= ~bb;
+    squares[square] = Square();
+}
+
+// Moves a piece to an empty square, updating the bitboards, hashes and piece-square score
+void Board::movePiece(int from, int to) {
+    Square sq = squares[from];
+    Bitboard fromTo = Bitboards::squareBB(from) | Bitboards::squareBB(to);
+    hashKey ^= Zobrist::keys.pieces[sq.colour][sq.piece][from] ^ Zobrist::keys.pieces[sq.colour][sq.piece][to];
+    if (sq.piece == PAWN)
+        pawnHashKey ^= Zobrist::keys.pieces[sq.colour][PAWN][from] ^ Zobrist::keys.pieces[sq.colour][PAWN][to];
+    psqtValue += PSQT::table.scores[sq.colour][sq.piece][to] - PSQT::table.scores[sq.colour][sq.piece][from];
+    pieceBB[sq.colour][sq.piece] ^= fromTo;
+    colourBB[sq.colour] ^= fromTo;
+    occupiedBB ^= fromTo;
+    squares[to] = sq;
+    squares[from] = Square();
 }
 
 // Prints a textual representation of the board
@@ -70,10 +144,10 @@ void Board::display() const {
     std::cout << "   a b c d e f g h\n";
     std::cout << "Side to move: " << (sideToMove == WHITE ? "White" : "Black") << "\n";
     std::cout << "Castling rights: "
-              << (castlingRights[0] ? "K" : "")
-              << (castlingRights[1] ? "Q" : "")
-              << (castlingRights[2] ? "k" : "")
-              << (castlingRights[3] ? "q" : "") << "\n";
+              << (castlingRights & WHITE_KINGSIDE ? "K" : "")
+              << (castlingRights & WHITE_QUEENSIDE ? "Q" : "")
+              << (castlingRights & BLACK_KINGSIDE ? "k" : "")
+              << (castlingRights & BLACK_QUEENSIDE ? "q" : "") << "\n";
     if (enPassantSquare != -1) {
         int f, r;
         indexToCoords(enPassantSquare, f, r);
@@ -83,23 +157,27 @@ void Board::display() const {
     std::cout << "Fullmove number: " << fullmoveNumber << "\n";
 }
 
-// Applies a move in Move struct form
-bool Board::makeMove(const Move& move) {
-    Square& source = squares[move.from];
-    Square& destination = squares[move.to];
+// Applies a move in Move struct form. No validation: the move is trusted to be legal here
+void Board::makeMove(const Move& move) {
+    Square source = squares[move.from];
+    Square destination = squares[move.to];
 
-    // Check if source piece matches side to move
-    if (source.colour != sideToMove || source.piece == EMPTY) {
-        std::cout << "No " << (sideToMove == WHITE ? "White" : "Black") << " piece on source square.\n";
-        return false;
-    }
+    // Save the state this move will overwrite so unmakeMove can restore it
+    UndoState undo;
+    undo.hash = hashKey;
+    undo.captured = destination;
+    undo.castlingRights = castlingRights;
+    undo.enPassantSquare = static_cast<int8_t>(enPassantSquare);
+    undo.halfmoveClock = static_cast<uint16_t>(halfmoveClock);
+    history.push_back(undo);
+
+    // Take the old castling rights and en passant file out of the hash; the new ones are added back below
+    hashKey ^= Zobrist::keys.castling[castlingRights];
+    if (enPassantSquare != -1)
+        hashKey ^= Zobrist::keys.enPassant[enPassantSquare % BOARD_SIZE];
 
     // Handle castling moves
     if (move.isCastle) {
-        if (!isLegalCastle(move)) {
-            std::cout << "Illegal castling move.\n";
-            return false;
-        }
         // Kingside or queenside
         int kingFrom = move.from;
         int kingTo = move.to;
@@ -111,72 +189,120 @@ bool Board::makeMove(const Move& move) {
             rookFrom = kingFrom - 4;
             rookTo = kingFrom - 1;
         }
-        squares[rookTo] = squares[rookFrom]; // Move rook
-        squares[rookFrom] = Square();
-        destination = source; // Move king
-        source = Square();
-        updateCastlingRights(move);
+        movePiece(rookFrom, rookTo); // Move rook
+        movePiece(kingFrom, kingTo); // Move king
         clearEnPassant();
-        sideToMove = (sideToMove == WHITE ? BLACK : WHITE);
-        if (sideToMove == WHITE) fullmoveNumber++;
         halfmoveClock++;
-        return true;
-    }
-
-    // Handle en passant
-    if (move.isEnPassant) {
-        if (!isLegalEnPassant(move)) {
-            std::cout << "Illegal en passant move.\n";
-            return false;
-        }
-        destination = source; // Move pawn
-        source = Square();
+    } else if (move.isEnPassant) {
+        // Handle en passant
+        movePiece(move.from, move.to); // Move pawn
         // Remove captured pawn
         int epCaptureSq = move.to + (sideToMove == WHITE ? -BOARD_SIZE : BOARD_SIZE);
-        squares[epCaptureSq] = Square();
+        removePiece(epCaptureSq);
         clearEnPassant();
-        updateCastlingRights(move);
-        sideToMove = (sideToMove == WHITE ? BLACK : WHITE);
-        if (sideToMove == WHITE) fullmoveNumber++;
         halfmoveClock = 0; // Reset halfmove clock for capture
-        return true;
-    }
-
-    // Standard moves
-    // Handle pawn double advance for en passant
-    if (source.piece == PAWN && std::abs(move.to - move.from) == 2 * BOARD_SIZE) {
-        enPassantSquare = (move.from + move.to) / 2;
     } else {
-        clearEnPassant();
-    }
+        // Standard moves
+        // Handle pawn double advance for en passant
+        if (source.piece == PAWN && std::abs(move.to - move.from) == 2 * BOARD_SIZE) {
+            enPassantSquare = (move.from + move.to) / 2;
+        } else {
+            clearEnPassant();
+        }
 
-    // Handle promotion
-    if (move.promotion != EMPTY) {
-        destination = Square(move.promotion, source.colour);
-    } else {
-        destination = source;
+        // If move is a capture or pawn move, reset halfmove clock
+        if (destination.piece != EMPTY || source.piece == PAWN)
+            halfmoveClock = 0;
+        else
+            halfmoveClock++;
+
+        // Remove any captured piece, then move the piece across
+        removePiece(move.to);
+        movePiece(move.from, move.to);
+
+        // Handle promotion
+        if (move.promotion != EMPTY) {
+            removePiece(move.to);
+            putPiece(move.to, move.promotion, source.colour);
+        }
     }
-    // If move is a capture or pawn move, reset halfmove clock
-    if (destination.piece != EMPTY || source.piece == PAWN)
-        halfmoveClock = 0;
-    else
-        halfmoveClock++;
 
-    source = Square(); // Empty source square
     updateCastlingRights(move);
     sideToMove = (sideToMove == WHITE ? BLACK : WHITE);
     if (sideToMove == WHITE) fullmoveNumber++;
-    return true;
+
+    hashKey ^= Zobrist::keys.castling[castlingRights] ^ Zobrist::keys.sideToMove;
+    if (enPassantSquare != -1)
+        hashKey ^= Zobrist::keys.enPassant[enPassantSquare % BOARD_SIZE];
+}
+
+// Validates a move against the legal moves of the current position before handing it to makeMove.
+// The generated move is the one applied, so its castling and en passant flags are always right.
+Board::MoveError Board::tryMove(const Move& move) {
+    Square source = squares[move.from];
+    if (source.colour != sideToMove || source.piece == EMPTY)
+        return MOVE_NO_PIECE;
+    for (const auto& legal : MoveGen::generateLegalMoves(*this)) {
+        if (legal.from == move.from && legal.to == move.to && legal.promotion == move.promotion) {
+            makeMove(legal);
+            return MOVE_OK;
+        }
+    }
+    if (move.isCastle)
+        return MOVE_ILLEGAL_CASTLE;
+    if (move.isEnPassant)
+        return MOVE_ILLEGAL_EN_PASSANT;
+    return MOVE_ILLEGAL;
+}
+
+// Takes back a move, reversing makeMove step by step and restoring the saved state
+void Board::unmakeMove(const Move& move) {
+    UndoState undo = history.back();
+    history.pop_back();
+
+    if (sideToMove == WHITE) fullmoveNumber--;
+    sideToMove = (sideToMove == WHITE ? BLACK : WHITE);
+
+    if (move.isCastle) {
+        // Return the king and rook to their home squares
+        int rookFrom, rookTo;
+        if (move.to > move.from) { // Kingside
+            rookFrom = move.from + 3;
+            rookTo = move.from + 1;
+        } else { // Queenside
+            rookFrom = move.from - 4;
+            rookTo = move.from - 1;
+        }
+        movePiece(move.to, move.from);
+        movePiece(rookTo, rookFrom);
+    } else if (move.isEnPassant) {
+        // Return the pawn and restore the pawn it captured
+        movePiece(move.to, move.from);
+        int epCaptureSq = move.to + (sideToMove == WHITE ? -BOARD_SIZE : BOARD_SIZE);
+        putPiece(epCaptureSq, PAWN, sideToMove == WHITE ? BLACK : WHITE);
+    } else {
+        // Turn a promoted piece back into a pawn, then move it back and restore any capture
+        if (move.promotion != EMPTY) {
+            removePiece(move.to);
+            putPiece(move.to, PAWN, sideToMove);
+        }
+        movePiece(move.to, move.from);
+        if (undo.captured.piece != EMPTY)
+            putPiece(move.to, undo.captured.piece, undo.captured.colour);
+    }
+
+    castlingRights = undo.castlingRights;
+    enPassantSquare = undo.enPassantSquare;
+    halfmoveClock = undo.halfmoveClock;
+    hashKey = undo.hash; // The piece helpers above updated the hash too; the saved value is authoritative
 }
 
 // Applies a move given in algebraic notation ("e2e4", etc.)
-bool Board::makeMove(const std::string& moveStr) {
+Board::MoveError Board::tryMove(const std::string& moveStr) {
     Move move(0, 0);
-    if (!parseMove(moveStr, move)) {
-        std::cout << "Invalid move format: " << moveStr << "\n";
-        return false;
-    }
-    return makeMove(move);
+    if (!parseMove(moveStr, move))
+        return MOVE_BAD_NOTATION;
+    return tryMove(move);
 }
 
 // Checks if the game is over (checkmate, stalemate, etc.)
@@ -186,6 +312,22 @@ bool Board::isGameOver() const {
     return false;
 }
 
+// Looks outward from the square with each piece's attack pattern and intersects with the pieces that move
+// that way. A square is attacked by a white pawn exactly when a black pawn on it would attack that pawn's
+// square, so pawn attackers are found with the opposite colour's pattern.
+Bitboard Board::attackersTo(int square, Bitboard occupancy) const {
+    Bitboard queens = pieceBB[WHITE][QUEEN] | pieceBB[BLACK][QUEEN];
+    Bitboard bishopsQueens = pieceBB[WHITE][BISHOP] | pieceBB[BLACK][BISHOP] | queens;
+    Bitboard rooksQueens = pieceBB[WHITE][ROOK] | pieceBB[BLACK][ROOK] | queens;
+
+    return (Attacks::pawnAttacks(BLACK, square) & pieceBB[WHITE][PAWN])
+         | (Attacks::pawnAttacks(WHITE, square) & pieceBB[BLACK][PAWN])
+         | (Attacks::knightAttacks(square) & (pieceBB[WHITE][KNIGHT] | pieceBB[BLACK][KNIGHT]))
+         | (Attacks::kingAttacks(square) & (pieceBB[WHITE][KING] | pieceBB[BLACK][KING]))
+         | (Attacks::bishopAttacks(square, occupancy) & bishopsQueens)
+         | (Attacks::rookAttacks(square, occupancy) & rooksQueens);
+}
+
 // Returns side to move
 Board::Colour Board::getSideToMove() const {
     return sideToMove;
@@ -228,10 +370,10 @@ std::string Board::getFEN() const {
     fen << ' ' << (sideToMove == WHITE ? 'w' : 'b');
     // Castling rights
     std::string castling;
-    if (castlingRights[0]) castling += 'K';
-    if (castlingRights[1]) castling += 'Q';
-    if (castlingRights[2]) castling += 'k';
-    if (castlingRights[3]) castling += 'q';
+    if (castlingRights & WHITE_KINGSIDE) castling += 'K';
+    if (castlingRights & WHITE_QUEENSIDE) castling += 'Q';
+    if (castlingRights & BLACK_KINGSIDE) castling += 'k';
+    if (castlingRights & BLACK_QUEENSIDE) castling += 'q';
     fen << ' ' << (castling.empty() ? "-" : castling);
     // En passant
     if (enPassantSquare == -1) {
@@ -265,7 +407,8 @@ void Board::indexToCoords(int index, int& file, int& rank) {
 
 // Get castling rights
 std::array<bool, 4> Board::getCastlingRights() const {
-    return castlingRights;
+    return {(castlingRights & WHITE_KINGSIDE) != 0, (castlingRights & WHITE_QUEENSIDE) != 0,
+            (castlingRights & BLACK_KINGSIDE) != 0, (castlingRights & BLACK_QUEENSIDE) != 0};
 }
 
 // Get en passant target square
@@ -278,29 +421,19 @@ void Board::clearEnPassant() {
     enPassantSquare = -1;
 }
 
-// Helper: updates castling rights if king or rook moves
+// Helper: updates castling rights if king or rook moves, or a rook is captured on its home square.
+// Must be called with the move's from/to squares; the board contents are not consulted.
 void Board::updateCastlingRights(const Move& move) {
-    // White king moves
-    if (move.from == toIndex(4, 0)) {
-        castlingRights[0] = false; // White kingside
-        castlingRights[1] = false; // White queenside
-    }
-    // Black king moves
-    if (move.from == toIndex(4, 7)) {
-        castlingRights[2] = false; // Black kingside
-        castlingRights[3] = false; // Black queenside
+    for (int sq : {move.from, move.to}) {
+        // King home squares
+        if (sq == toIndex(4, 0)) castlingRights &= ~(WHITE_KINGSIDE | WHITE_QUEENSIDE);
+        if (sq == toIndex(4, 7)) castlingRights &= ~(BLACK_KINGSIDE | BLACK_QUEENSIDE);
+        // Rook home squares
+        if (sq == toIndex(0, 0)) castlingRights &= ~WHITE_QUEENSIDE;
+        if (sq == toIndex(7, 0)) castlingRights &= ~WHITE_KINGSIDE;
+        if (sq == toIndex(0, 7)) castlingRights &= ~BLACK_QUEENSIDE;
+        if (sq == toIndex(7, 7)) castlingRights &= ~BLACK_KINGSIDE;
     }
-    // White rook moves
-    if (move.from == toIndex(0, 0)) castlingRights[1] = false; // White queenside
-    if (move.from == toIndex(7, 0)) castlingRights[0] = false; // White kingside
-    // Black rook moves
-    if (move.from == toIndex(0, 7)) castlingRights[3] = false; // Black queenside
-    if (move.from == toIndex(7, 7)) castlingRights[2] = false; // Black kingside
-    // If rook is captured
-    if (move.to == toIndex(0, 0) && squares[move.to].piece == ROOK) castlingRights[1] = false;
-    if (move.to == toIndex(7, 0) && squares[move.to].piece == ROOK) castlingRights[0] = false;
-    if (move.to == toIndex(0, 7) && squares[move.to].piece == ROOK) castlingRights[3] = false;
-    if (move.to == toIndex(7, 7) && squares[move.to].piece == ROOK) castlingRights[2] = false;
 }
 
 // Helper: parses algebraic move notation "e2e4", "e7e8q", etc.
@@ -348,34 +481,6 @@ bool Board::parseMove(const std::string& moveStr, Move& move) const {
     return true;
 }
 
-// Helper: checks if castling move is legal (must add further checks for king not in check and squares not attacked)
-bool Board::isLegalCastle(const Move& move) const {
-    // For simplicity, just check castling rights and empty squares between king and rook
-    // Full legality (king not in check, squares not attacked) should be checked in movegen
-    int rank = (sideToMove == WHITE) ? 0 : 7;
-    if (move.to > move.from) { // Kingside
-        if (!(sideToMove == WHITE ? castlingRights[0] : castlingRights[2]))
-            return false;
-        // Squares between king and rook must be empty
-        for (int f = 5; f <= 6; ++f)
-            if (getSquare(toIndex(f, rank)).piece != EMPTY)
-                return false;
-    } else { // Queenside
-        if (!(sideToMove == WHITE ? castlingRights[1] : castlingRights[3]))
-            return false;
-        for (int f = 1; f <= 3; ++f)
-            if (getSquare(toIndex(f, rank)).piece != EMPTY)
-                return false;
-    }
-    return true;
-}
-
-// Helper: checks if en passant move is legal (target square matches and pawn is in correct rank)
-bool Board::isLegalEnPassant(const Move& move) const {
-    // Check en passant square
-    return enPassantSquare == move.to;
-}
-
 // Helper: checks if a square is attacked by the given colour (basic placeholder, extend for full legality)
 bool Board::isSquareAttacked(int square, Colour attacker) const {
     // For now, this is a placeholder.
@@ -1,98 +1,11 @@
 #include "evaluate.h"
-#include "movegen.h"
+#include "attacks.h"
 #include <algorithm>
 
-// Piece-square tables (values in centipawns).
-// White's perspective; for Black, mirror vertically.
-const int Evaluate::pawnTable[64] = {
-      0,  0,  0,  0,  0,  0,  0,  0,
-     10, 10, 10, 10, 10, 10, 10, 10,
-      5,  5,  8, 12, 12,  8,  5,  5,
-      2,  2,  4, 10, 10,  4,  2,  2,
-      1,  1,  2,  5,  5,  2,  1,  1,
-      0,  0,  0,  0,  0,  0,  0,  0,
-      0,  0,  0, -2, -2,  0,  0,  0,
-      0,  0,  0,  0,  0,  0,  0,  0
-};
-const int Evaluate::knightTable[64] = {
-    -50,-40,-30,-30,-30,-30,-40,-50,
-    -40,-20,  0,  0,  0,  0,-20,-40,
-    -30,  0, 10, 15, 15, 10,  0,-30,
-    -30,  5, 15, 20, 20, 15,  5,-30,
-    -30,  0, 15, 20, 20, 15,  0,-30,
-    -30,  5, 10, 15, 15, 10,  5,-30,
-    -40,-20,  0,  5,  5,  0,-20,-40,
-    -50,-40,-30,-30,-30,-30,-40,-50
-};
-const int Evaluate::bishopTable[64] = {
-    -20,-10,-10,-10,-10,-10,-10,-20,
-    -10,  5,  0,  0,  0,  0,  5,-10,
-    -10, 10, 10, 10, 10, 10, 10,-10,
-    -10,  0, 10, 10, 10, 10,  0,-10,
-    -10,  5,  5, 10, 10,  5,  5,-10,
-    -10,  0,  5, 10, 10,  5,  0,-10,
-    -10,  0,  0,  0,  0,  0,  0,-10,
-    -20,-10,-10,-10,-10,-10,-10,-20
-};
-const int Evaluate::rookTable[64] = {
-     0,  0,  5, 10, 10,  5,  0,  0,
-    -5,  0,  0,  0,  0,  0,  0, -5,
-    -5,  0,  0,  0,  0,  0,  0, -5,
-    -5,  0,  0,  0,  0,  0,  0, -5,
-    -5,  0,  0,  0,  0,  0,  0, -5,
-    -5,  0,  0,  0,  0,  0,  0, -5,
-     5, 10, 10, 10, 10, 10, 10,  5,
-     0,  0,  0,  0,  0,  0,  0,  0
-};
-const int Evaluate::queenTable[64] = {
-    -20,-10,-10, -5, -5,-10,-10,-20,
-    -10,  0,  0,  0,  0,  0,  0,-10,
-    -10,  0,  5,  5,  5,  5,  0,-10,
-     -5,  0,  5,  5,  5,  5,  0, -5,
-      0,  0,  5,  5,  5,  5,  0, -5,
-    -10,  5,  5,  5,  5,  5,  0,-10,
-    -10,  0,  5,  0,  0,  0,  0,-10,
-    -20,-10,-10, -5, -5,-10,-10,-20
-};
-const int Evaluate::kingTable[64] = {
-    -30,-40,-40,-50,-50,-40,-40,-30,
-    -30,-40,-40,-50,-50,-40,-40,-30,
-    -30,-40,-40,-50,-50,-40,-40,-30,
-    -30,-40,-40,-50,-50,-40,-40,-30,
-    -20,-30,-30,-40,-40,-30,-30,-20,
-    -10,-20,-20,-20,-20,-20,-20,-10,
-     20, 20,  0,  0,  0,  0, 20, 20,
-     20, 30, 10,  0,  0, 10, 30, 20
-};
-
 // Returns the material value assigned to a given piece type.
-// These values can be tuned for improved engine strength.
+// The values themselves live in PSQT so that Board can keep its running score with them.
 int Evaluate::getMaterialValue(Board::Piece piece) {
-    switch (piece) {
-        case Board::PAWN:   return PAWN_VALUE;
-        case Board::KNIGHT: return KNIGHT_VALUE;
-        case Board::BISHOP: return BISHOP_VALUE;
-        case Board::ROOK:   return ROOK_VALUE;
-        case Board::QUEEN:  return QUEEN_VALUE;
-        case Board::KING:   return KING_VALUE;
-        default:            return 0;
-    }
-}
-
-// Returns the value for a piece on a given square using its piece-square table.
-// Mirrors the table for Black's perspective.
-int Evaluate::getPieceSquareValue(Board::Piece piece, int square, Board::Colour colour) {
-    // Mirror vertically for Black
-    int idx = (colour == Board::WHITE) ? square : ((square / 8) * 8 + (7 - (square % 8)));
-    switch (piece) {
-        case Board::PAWN:   return pawnTable[idx];
-        case Board::KNIGHT: return knightTable[idx];
-        case Board::BISHOP: return bishopTable[idx];
-        case Board::ROOK:   return rookTable[idx];
-        case Board::QUEEN:  return queenTable[idx];
-        case Board::KING:   return kingTable[idx];
-        default:            return 0;
-    }
+    return PSQT::PIECE_VALUE[piece];
 }
 
 // Returns a bonus for retaining castling rights.
@@ -106,37 +19,151 @@ int Evaluate::evaluateCastling(const Board& board) {
     return bonus;
 }
 
-// Basic evaluation of doubled pawns. More advanced pawn structure analysis can be added later.
-int Evaluate::evaluatePawnStructure(const Board& board) {
-    int score = 0;
-    // Count doubled pawns for each file and side
-    for (int file = 0; file < Board::BOARD_SIZE; ++file) {
-        int whitePawns = 0, blackPawns = 0;
-        for (int rank = 0; rank < Board::BOARD_SIZE; ++rank) {
-            int sq = Board::toIndex(file, rank);
-            Board::Square s = board.getSquare(sq);
-            if (s.piece == Board::PAWN) {
-                if (s.colour == Board::WHITE) whitePawns++;
-                else if (s.colour == Board::BLACK) blackPawns++;
-            }
+// Looks the pawn formation up by its key; on a miss the slot is overwritten with a fresh evaluation.
+const Evaluate::PawnEntry& Evaluate::probePawnTable(const Board& board, PawnTable& pawnTable) {
+    if (pawnTable.empty())
+        pawnTable.resize(PAWN_TABLE_SIZE);
+
+    uint64_t key = board.pawnKey();
+    PawnEntry& entry = pawnTable[key & (PAWN_TABLE_SIZE - 1)];
+    if (entry.key != key) {
+        evaluatePawnStructure(board, entry);
+        entry.key = key;
+    }
+    return entry;
+}
+
+// Scores both sides' pawns, White minus Black.
+void Evaluate::evaluatePawnStructure(const Board& board, PawnEntry& entry) {
+    entry.score = evaluatePawns(board, Board::WHITE, entry) - evaluatePawns(board, Board::BLACK, entry);
+}
+
+// Looks at each pawn in turn against its own and the enemy pawns:
+// doubled (another friendly pawn ahead on the file), isolated (no friendly pawn on either adjacent file),
+// backward (every friendly pawn on the adjacent files is ahead of it, and an enemy pawn guards its next square),
+// connected (defended by a friendly pawn, or with one alongside), and passed (no enemy pawn ahead of it
+// on its own or an adjacent file; rewarded more the further it has advanced).
+PSQT::Score Evaluate::evaluatePawns(const Board& board, Board::Colour colour, PawnEntry& entry) {
+    Board::Colour enemy = (colour == Board::WHITE) ? Board::BLACK : Board::WHITE;
+    Bitboard ours = board.getPieces(colour, Board::PAWN);
+    Bitboard theirs = board.getPieces(enemy, Board::PAWN);
+    Bitboard ourAttacks = pawnAttacks(ours, colour);
+    Bitboard theirAttacks = pawnAttacks(theirs, enemy);
+
+    PSQT::Score score = 0;
+    entry.passed[colour] = 0;
+    entry.semiOpenFiles[colour] = 0;
+    for (int file = 0; file < Board::BOARD_SIZE; ++file)
+        if (!(ours & Bitboards::fileBB(file)))
+            entry.semiOpenFiles[colour] |= Bitboards::fileBB(file);
+
+    Bitboard pawns = ours;
+    while (pawns) {
+        int sq = Bitboards::popLsb(pawns);
+        int file = sq % Board::BOARD_SIZE;
+        int rank = sq / Board::BOARD_SIZE;
+        int relativeRank = (colour == Board::WHITE) ? rank : Board::BOARD_SIZE - 1 - rank;
+        int stop = (colour == Board::WHITE) ? sq + Board::BOARD_SIZE : sq - Board::BOARD_SIZE;
+
+        // Ranks strictly ahead of the pawn, from its own side's point of view
+        Bitboard ahead = (colour == Board::WHITE)
+            ? ((rank == 7) ? 0 : ~0ULL << (Board::BOARD_SIZE * (rank + 1)))
+            : ((rank == 0) ? 0 : ~0ULL >> (Board::BOARD_SIZE * (Board::BOARD_SIZE - rank)));
+        Bitboard fileMask = Bitboards::fileBB(file);
+        Bitboard adjacentFiles = ((file > 0) ? Bitboards::fileBB(file - 1) : 0)
+                               | ((file < 7) ? Bitboards::fileBB(file + 1) : 0);
+
+        if (ours & fileMask & ahead)
+            score += DOUBLED_PAWN;
+
+        if (!(ours & adjacentFiles))
+            score += ISOLATED_PAWN;
+        else if (!(ours & adjacentFiles & ~ahead) && Bitboards::testBit(theirAttacks, stop))
+            score += BACKWARD_PAWN;
+
+        if (Bitboards::testBit(ourAttacks, sq) || (ours & adjacentFiles & Bitboards::rankBB(rank)))
+            score += CONNECTED_PAWN;
+
+        if (!(theirs & (fileMask | adjacentFiles) & ahead)) {
+            entry.passed[colour] |= Bitboards::squareBB(sq);
+            score += PSQT::makeScore(PASSED_PAWN_MG[relativeRank], PASSED_PAWN_EG[relativeRank]);
         }
-        if (whitePawns > 1) score -= 10 * (whitePawns - 1); // Penalty for doubled white pawns
-        if (blackPawns > 1) score += 10 * (blackPawns - 1); // Penalty for doubled black pawns (negative for Black)
     }
     return score;
 }
 
-// Simple mobility evaluation: number of legal moves for each side.
-// Gives a small bonus for having higher mobility.
+// Uses the cached masks with the current piece placement, White minus Black.
+PSQT::Score Evaluate::evaluatePawnMasks(const Board& board, const PawnEntry& entry) {
+    PSQT::Score score = 0;
+    Bitboard openFiles = entry.semiOpenFiles[Board::WHITE] & entry.semiOpenFiles[Board::BLACK];
+    Bitboard empty = ~board.getOccupancy();
+    for (int c = Board::WHITE; c <= Board::BLACK; ++c) {
+        Board::Colour colour = static_cast<Board::Colour>(c);
+        Bitboard rooks = board.getPieces(colour, Board::ROOK);
+        PSQT::Score side = ROOK_OPEN_FILE * Bitboards::popCount(rooks & openFiles)
+                         + ROOK_SEMI_OPEN_FILE * Bitboards::popCount(rooks & entry.semiOpenFiles[colour] & ~openFiles);
+
+        // Passed pawns whose next square is empty
+        Bitboard passed = entry.passed[colour];
+        Bitboard stops = (colour == Board::WHITE) ? passed << Board::BOARD_SIZE : passed >> Board::BOARD_SIZE;
+        side += FREE_PASSED_PAWN * Bitboards::popCount(stops & empty);
+
+        score += (colour == Board::WHITE) ? side : -side;
+    }
+    return score;
+}
+
+// Mobility evaluation: weighted count of the squares each piece attacks, White minus Black.
+// Works straight from the attack tables, so no moves are generated and the board is not copied.
 int Evaluate::evaluateMobility(const Board& board) {
-    auto whiteMoves = MoveGen::generateLegalMoves(board);
-    Board boardCopy = board;
-    boardCopy.makeMove("a2a3"); // Dummy move to switch turn
-    auto blackMoves = MoveGen::generateLegalMoves(boardCopy);
-    int mobility = static_cast<int>(whiteMoves.size()) - static_cast<int>(blackMoves.size());
+    return sideMobility(board, Board::WHITE) - sideMobility(board, Board::BLACK);
+}
+
+// Squares holding friendly pieces or covered by enemy pawns are not counted: a piece cannot go to the
+// first, and would usually be lost for a pawn on the second.
+int Evaluate::sideMobility(const Board& board, Board::Colour colour) {
+    Board::Colour enemy = (colour == Board::WHITE) ? Board::BLACK : Board::WHITE;
+    Bitboard occupancy = board.getOccupancy();
+    Bitboard area = ~board.getColourPieces(colour) & ~pawnAttacks(board.getPieces(enemy, Board::PAWN), enemy);
+
+    int mobility = 0;
+    for (int p = Board::KNIGHT; p <= Board::QUEEN; ++p) {
+        Board::Piece piece = static_cast<Board::Piece>(p);
+        Bitboard pieces = board.getPieces(colour, piece);
+        while (pieces) {
+            int sq = Bitboards::popLsb(pieces);
+            Bitboard attacks;
+            switch (piece) {
+                case Board::KNIGHT: attacks = Attacks::knightAttacks(sq); break;
+                case Board::BISHOP: attacks = Attacks::bishopAttacks(sq, occupancy); break;
+                case Board::ROOK:   attacks = Attacks::rookAttacks(sq, occupancy); break;
+                default:            attacks = Attacks::queenAttacks(sq, occupancy); break;
+            }
+            mobility += MOBILITY_WEIGHT[piece] * Bitboards::popCount(attacks & area);
+        }
+    }
     return mobility;
 }
 
+// Shifts the pawns one rank forward and one file to each side, dropping those that would wrap around the board.
+Bitboard Evaluate::pawnAttacks(Bitboard pawns, Board::Colour colour) {
+    if (colour == Board::WHITE)
+        return ((pawns & ~Bitboards::FILE_A) << 7) | ((pawns & ~Bitboards::FILE_H) << 9);
+    return ((pawns & ~Bitboards::FILE_A) >> 9) | ((pawns & ~Bitboards::FILE_H) >> 7);
+}
+
+// Game phase from the non-pawn material of both sides: MAX_PHASE with every piece on the board,
+// falling to 0 as pieces are traded. Extra pieces from promotion are capped at MAX_PHASE.
+int Evaluate::gamePhase(const Board& board) {
+    int phase = 0;
+    for (int p = Board::KNIGHT; p <= Board::QUEEN; ++p) {
+        Board::Piece piece = static_cast<Board::Piece>(p);
+        int count = Bitboards::popCount(board.getPieces(Board::WHITE, piece) | board.getPieces(Board::BLACK, piece));
+        phase += PSQT::PHASE_WEIGHT[piece] * count;
+    }
+    return std::min(phase, PSQT::MAX_PHASE);
+}
+
 // Checks if the game is over and applies large positive/negative/draw scores.
 int Evaluate::evaluateGameStatus(const Board& board) {
     // Placeholder: always returns 0 for now.
@@ -144,29 +171,30 @@ int Evaluate::evaluateGameStatus(const Board& board) {
     return 0;
 }
 
-// Main evaluation function: combines material, piece-square, and basic positional scores.
+// Evaluation without a pawn table: the pawn structure is worked out for this call only.
 int Evaluate::score(const Board& board) {
-    int score = 0;
-
-    // Loop over all squares on the board.
-    for (int sq = 0; sq < Board::NUM_SQUARES; ++sq) {
-        Board::Square piece = board.getSquare(sq);
-        if (piece.piece == Board::EMPTY) continue;
-        int material = getMaterialValue(piece.piece);
-        int pst = getPieceSquareValue(piece.piece, sq, piece.colour);
-        // Add for White, subtract for Black.
-        if (piece.colour == Board::WHITE)
-            score += material + pst;
-        else if (piece.colour == Board::BLACK)
-            score -= material + pst;
-    }
+    PawnEntry pawns;
+    evaluatePawnStructure(board, pawns);
+    return score(board, pawns);
+}
+
+// Evaluation with the pawn structure taken from (or added to) the caller's pawn table.
+int Evaluate::score(const Board& board, PawnTable& pawnTable) {
+    return score(board, probePawnTable(board, pawnTable));
+}
+
+// Main evaluation function: combines material, piece-square, and basic positional scores.
+int Evaluate::score(const Board& board, const PawnEntry& pawns) {
+    // Material and piece-square score, kept up to date by the board as pieces move, plus the pawn
+    // structure and the terms built on its masks. All three are middlegame/endgame
+    // pairs, blended by the material left on the board.
+    PSQT::Score tapered = board.psqtScore() + pawns.score + evaluatePawnMasks(board, pawns);
+    int phase = gamePhase(board);
+    int score = (PSQT::mgValue(tapered) * phase + PSQT::egValue(tapered) * (PSQT::MAX_PHASE - phase)) / PSQT::MAX_PHASE;
 
     // Add castling rights bonus.
     score += evaluateCastling(board);
 
-    // Add pawn structure evaluation.
-    score += evaluatePawnStructure(board);
-
     // Add mobility bonus.
     score += evaluateMobility(board);
 
@@ -1,15 +1,36 @@
 #include <iostream>
 #include <string>
+#include <sstream>
+#include <chrono>
+#include <algorithm>
 #include "board.h"
+#include "attacks.h"
 #include "movegen.h"
 #include "perft.h"
+#include "uci.h"
 
 // Entry point for the chess engine.
 // This main file sets up the engine, provides a simple command loop, and acts as a demonstration/test harness.
 // It is designed to be extensible so you can add features like UCI support, evaluation, and search algorithms later.
 // Detailed UK English comments are provided to help you understand and extend the code.
 
+// Turns a rejected move into a message for the user; the board itself never prints.
+static std::string describeMoveError(Board::MoveError error, const Board& board) {
+    switch (error) {
+        case Board::MOVE_BAD_NOTATION:       return "invalid move format";
+        case Board::MOVE_NO_PIECE:           return std::string("no ") + (board.getSideToMove() == Board::WHITE ? "White" : "Black")
+                                                    + " piece on source square";
+        case Board::MOVE_ILLEGAL_CASTLE:     return "illegal castling move";
+        case Board::MOVE_ILLEGAL_EN_PASSANT: return "illegal en passant move";
+        case Board::MOVE_ILLEGAL:            return "illegal move";
+        default:                             return "unknown error";
+    }
+}
+
 int main() {
+    // Build the sliding-piece attack tables before any move generation takes place.
+    Attacks::init();
+
     // Create the chess board and initialise to standard starting position.
     Board board;
     board.reset();
@@ -33,25 +54,46 @@ int main() {
             std::cout << "Commands:\n";
             std::cout << "  move <algebraic>   - Make a move (e.g., e2e4, e7e8q)\n";
             std::cout << "  fen                - Show FEN of current position\n";
-            std::cout << "  perft <depth>      - Run perft test to given depth\n";
+            std::cout << "  perft <depth> [threads <n>] [hash <mb>]\n";
+            std::cout << "                     - Run perft test to given depth (optionally in parallel and/or hashed)\n";
             std::cout << "  reset              - Reset board to starting position\n";
+            std::cout << "  uci                - Switch to UCI mode (for GUIs)\n";
             std::cout << "  quit/exit          - Exit engine\n";
         } else if (command.substr(0, 5) == "move ") {
             // Extract move string.
             std::string moveStr = command.substr(5);
-            if (board.makeMove(moveStr)) {
+            Board::MoveError error = board.tryMove(moveStr);
+            if (error == Board::MOVE_OK) {
                 std::cout << "Move played: " << moveStr << "\n";
             } else {
-                std::cout << "Invalid move: " << moveStr << "\n";
+                std::cout << "Invalid move: " << moveStr << " (" << describeMoveError(error, board) << ")\n";
             }
         } else if (command == "fen") {
             std::cout << "FEN: " << board.getFEN() << "\n";
         } else if (command.substr(0, 6) == "perft ") {
-            // Run perft to the specified depth.
-            int depth = std::stoi(command.substr(6));
-            std::cout << "Running perft to depth " << depth << "...\n";
-            uint64_t nodes = Perft::run(board, depth);
-            std::cout << "Perft nodes: " << nodes << "\n";
+            // Run perft to the specified depth: "perft <depth> [threads <n>] [hash <mb>]".
+            std::istringstream args(command.substr(6));
+            int depth = 0, threads = 1, hashMb = 0;
+            std::string keyword;
+            args >> depth;
+            while (args >> keyword) {
+                if (keyword == "threads") args >> threads;
+                else if (keyword == "hash") args >> hashMb;
+            }
+            std::cout << "Running perft to depth " << depth << " on " << threads << " thread(s)...\n";
+            auto start = std::chrono::steady_clock::now();
+            size_t hashMegabytes = static_cast<size_t>(std::max(0, hashMb));
+            uint64_t nodes = (threads > 1) ? Perft::runParallel(board, depth, threads, hashMegabytes)
+                                           : Perft::run(board, depth, hashMegabytes);
+            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start).count();
+            std::cout << "Perft nodes: " << nodes << " (" << ms << " ms)\n";
+        } else if (command == "uci") {
+            // Hand over to the UCI protocol handler; it returns once the GUI sends "quit".
+            UCI uci;
+            if (uci.execute(command))
+                uci.run();
+            break;
         } else if (command == "reset") {
             board.reset();
             std::cout << "Board reset to starting position.\n";
@@ -1,58 +1,16 @@
 #include "movegen.h"
+#include "attacks.h"
 #include <cassert>
 #include <cctype>
 
-// Movement offsets for each piece type
-const int knightOffsets[8][2] = {
-    {1, 2}, {2, 1}, {2, -1}, {1, -2},
-    {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2}
-};
-const int bishopOffsets[4][2] = {
-    {1, 1}, {1, -1}, {-1, -1}, {-1, 1}
-};
-const int rookOffsets[4][2] = {
-    {1, 0}, {0, 1}, {-1, 0}, {0, -1}
-};
-const int kingOffsets[8][2] = {
-    {1, 1}, {1, 0}, {1, -1}, {0, -1},
-    {-1, -1}, {-1, 0}, {-1, 1}, {0, 1}
-};
-
 // Generate all pseudo-legal moves for the current board position.
-std::vector<Board::Move> MoveGen::generatePseudoLegalMoves(const Board& board) {
-    std::vector<Board::Move> moves;
+MoveList MoveGen::generatePseudoLegalMoves(const Board& board) {
+    MoveList moves;
     Board::Colour side = board.getSideToMove();
 
-    // Iterate through all squares to find pieces of the current side.
-    for (int sq = 0; sq < Board::NUM_SQUARES; ++sq) {
-        Board::Square square = board.getSquare(sq);
-        if (square.colour != side || square.piece == Board::EMPTY)
-            continue;
-
-        // Call the appropriate helper for each piece type.
-        switch (square.piece) {
-            case Board::PAWN:
-                addPawnMoves(board, sq, moves);
-                break;
-            case Board::KNIGHT:
-                addKnightMoves(board, sq, moves);
-                break;
-            case Board::BISHOP:
-                addBishopMoves(board, sq, moves);
-                break;
-            case Board::ROOK:
-                addRookMoves(board, sq, moves);
-                break;
-            case Board::QUEEN:
-                addQueenMoves(board, sq, moves);
-                break;
-            case Board::KING:
-                addKingMoves(board, sq, moves);
-                break;
-            default:
-                break;
-        }
-    }
+    // Any square not occupied by our own pieces is a potential destination.
+    addPieceMoves(board, moves, ~board.getColourPieces(side));
+
     // Add castling moves (if permitted by board state)
     addCastlingMoves(board, moves);
 
@@ -62,25 +20,166 @@ std::vector<Board::Move> MoveGen::generatePseudoLegalMoves(const Board& board) {
     return moves;
 }
 
+// Iterates through the bitboard of each piece type belonging to the current side.
+void MoveGen::addPieceMoves(const Board& board, MoveList& moves, Bitboard targets) {
+    Board::Colour side = board.getSideToMove();
+
+    Bitboard pieces = board.getPieces(side, Board::PAWN);
+    while (pieces)
+        addPawnMoves(board, Bitboards::popLsb(pieces), moves, ~Bitboards::EMPTY_BB, false);
+
+    pieces = board.getPieces(side, Board::KNIGHT);
+    while (pieces)
+        addKnightMoves(Bitboards::popLsb(pieces), moves, targets);
+
+    pieces = board.getPieces(side, Board::BISHOP);
+    while (pieces)
+        addBishopMoves(board, Bitboards::popLsb(pieces), moves, targets);
+
+    pieces = board.getPieces(side, Board::ROOK);
+    while (pieces)
+        addRookMoves(board, Bitboards::popLsb(pieces), moves, targets);
+
+    pieces = board.getPieces(side, Board::QUEEN);
+    while (pieces)
+        addQueenMoves(board, Bitboards::popLsb(pieces), moves, targets);
+
+    pieces = board.getPieces(side, Board::KING);
+    while (pieces)
+        addKingMoves(Bitboards::popLsb(pieces), moves, targets);
+}
+
 // Generate only legal moves (do not leave own king in check).
-std::vector<Board::Move> MoveGen::generateLegalMoves(const Board& board) {
-    std::vector<Board::Move> pseudoMoves = generatePseudoLegalMoves(board);
-    std::vector<Board::Move> legalMoves;
-
-    for (const auto& move : pseudoMoves) {
-        // Make a copy of the board and apply the move.
-        Board testBoard = board;
-        if (!testBoard.makeMove(move)) continue;
-
-        // Find king's location after the move.
-        int kingSq = findKingSquare(testBoard, board.getSideToMove());
-        Board::Colour opponent = (board.getSideToMove() == Board::WHITE) ? Board::BLACK : Board::WHITE;
-
-        // If king is not attacked, the move is legal.
-        if (kingSq != -1 && !isSquareAttacked(testBoard, kingSq, opponent))
-            legalMoves.push_back(move);
+MoveList MoveGen::generateLegalMoves(const Board& board) {
+    MoveList moves;
+    generateLegal(board, moves, false);
+    return moves;
+}
+
+// Generate only legal captures and promotions.
+MoveList MoveGen::generateLegalCaptures(const Board& board) {
+    MoveList moves;
+    generateLegal(board, moves, true);
+    return moves;
+}
+
+// Strictly legal generation. The king's attackers (checkers) and the pieces pinned to the king are
+// found once; after that every generated move is legal without making it:
+//  - King moves are kept if the destination is not attacked once the king has left its square
+//    (so a slider checking along a line still covers the square behind the king).
+//  - In double check only the king may move.
+//  - In single check other pieces may only capture the checker or block between it and the king.
+//  - A pinned piece may only move along the line through its king and the pinning piece.
+//  - En passant, which removes two pieces from a rank at once, is checked on the resulting occupancy.
+void MoveGen::generateLegal(const Board& board, MoveList& moves, bool capturesOnly) {
+    Board::Colour us = board.getSideToMove();
+    Board::Colour them = (us == Board::WHITE) ? Board::BLACK : Board::WHITE;
+    int kingSq = findKingSquare(board, us);
+    if (kingSq == -1) return; // Not a real position
+
+    Bitboard ours = board.getColourPieces(us);
+    Bitboard theirs = board.getColourPieces(them);
+    Bitboard occupancy = board.getOccupancy();
+    Bitboard checkers = board.attackersTo(kingSq, occupancy) & theirs;
+
+    // King moves
+    Bitboard kingTargets = Attacks::kingAttacks(kingSq) & (capturesOnly ? theirs : ~ours);
+    Bitboard withoutKing = occupancy ^ Bitboards::squareBB(kingSq);
+    while (kingTargets) {
+        int to = Bitboards::popLsb(kingTargets);
+        if (!(board.attackersTo(to, withoutKing) & theirs))
+            moves.emplace_back(kingSq, to);
     }
-    return legalMoves;
+
+    // Double check: nothing else can help.
+    if (Bitboards::popCount(checkers) > 1)
+        return;
+
+    // Single check: capture the checker or block its line.
+    Bitboard evasionMask = ~Bitboards::EMPTY_BB;
+    if (checkers) {
+        int checkerSq = Bitboards::lsb(checkers);
+        evasionMask = checkers | Attacks::between(kingSq, checkerSq);
+    }
+
+    Bitboard pinned = pinnedPieces(board, us, kingSq);
+    Bitboard targets = (capturesOnly ? theirs : ~ours) & evasionMask;
+
+    // Pawns test emptiness and enemy occupation themselves, so they only take the check and pin restrictions.
+    Bitboard pieces = board.getPieces(us, Board::PAWN);
+    while (pieces) {
+        int from = Bitboards::popLsb(pieces);
+        Bitboard allowed = evasionMask;
+        if (Bitboards::testBit(pinned, from))
+            allowed &= Attacks::line(kingSq, from);
+        addPawnMoves(board, from, moves, allowed, capturesOnly);
+    }
+
+    // A pinned knight can never stay on its pin line.
+    pieces = board.getPieces(us, Board::KNIGHT) & ~pinned;
+    while (pieces)
+        addKnightMoves(Bitboards::popLsb(pieces), moves, targets);
+
+    pieces = board.getPieces(us, Board::BISHOP);
+    while (pieces) {
+        int from = Bitboards::popLsb(pieces);
+        addBishopMoves(board, from, moves, Bitboards::testBit(pinned, from) ? targets & Attacks::line(kingSq, from) : targets);
+    }
+
+    pieces = board.getPieces(us, Board::ROOK);
+    while (pieces) {
+        int from = Bitboards::popLsb(pieces);
+        addRookMoves(board, from, moves, Bitboards::testBit(pinned, from) ? targets & Attacks::line(kingSq, from) : targets);
+    }
+
+    pieces = board.getPieces(us, Board::QUEEN);
+    while (pieces) {
+        int from = Bitboards::popLsb(pieces);
+        addQueenMoves(board, from, moves, Bitboards::testBit(pinned, from) ? targets & Attacks::line(kingSq, from) : targets);
+    }
+
+    // Castling is never possible out of check.
+    if (!checkers && !capturesOnly)
+        addCastlingMoves(board, moves);
+
+    // En passant: generated as before, then each candidate is verified on the resulting occupancy.
+    size_t first = moves.size();
+    addEnPassantMoves(board, moves);
+    size_t kept = first;
+    for (size_t i = first; i < moves.size(); ++i) {
+        if (enPassantIsLegal(board, moves[i], kingSq))
+            moves[kept++] = moves[i];
+    }
+    moves.resize(kept);
+}
+
+// A piece is pinned if it is the only piece between its king and an enemy slider on the same line.
+Bitboard MoveGen::pinnedPieces(const Board& board, Board::Colour side, int kingSq) {
+    Board::Colour enemy = (side == Board::WHITE) ? Board::BLACK : Board::WHITE;
+    Bitboard queens = board.getPieces(enemy, Board::QUEEN);
+    Bitboard snipers = (Attacks::rookAttacks(kingSq, 0) & (board.getPieces(enemy, Board::ROOK) | queens))
+                     | (Attacks::bishopAttacks(kingSq, 0) & (board.getPieces(enemy, Board::BISHOP) | queens));
+
+    Bitboard pinned = 0;
+    while (snipers) {
+        Bitboard blockers = Attacks::between(kingSq, Bitboards::popLsb(snipers)) & board.getOccupancy();
+        if (Bitboards::popCount(blockers) == 1)
+            pinned |= blockers & board.getColourPieces(side);
+    }
+    return pinned;
+}
+
+// Removes the capturing and captured pawns, adds the capturer on the target square, and checks
+// that nothing (other than the captured pawn) then attacks the king.
+bool MoveGen::enPassantIsLegal(const Board& board, const Board::Move& move, int kingSq) {
+    Board::Colour us = board.getSideToMove();
+    Board::Colour them = (us == Board::WHITE) ? Board::BLACK : Board::WHITE;
+    int capturedSq = Board::toIndex(move.to % Board::BOARD_SIZE, move.from / Board::BOARD_SIZE);
+
+    Bitboard occupancy = (board.getOccupancy() ^ Bitboards::squareBB(move.from) ^ Bitboards::squareBB(capturedSq))
+                       | Bitboards::squareBB(move.to);
+    Bitboard attackers = board.attackersTo(kingSq, occupancy) & board.getColourPieces(them);
+    return !(attackers & ~Bitboards::squareBB(capturedSq));
 }
 
 // Converts a Move structure to algebraic notation ("e2e4", "e7e8q", etc.).
@@ -118,7 +217,7 @@ bool MoveGen::isLegalMove(const Board& board, const Board::Move& move) {
 }
 
 // Helper: Generates all pawn moves (including promotions and double advances).
-void MoveGen::addPawnMoves(const Board& board, int from, std::vector<Board::Move>& moves) {
+void MoveGen::addPawnMoves(const Board& board, int from, MoveList& moves, Bitboard allowed, bool capturesOnly) {
     Board::Square pawn = board.getSquare(from);
     int file, rank;
     Board::indexToCoords(from, file, rank);
@@ -132,144 +231,82 @@ void MoveGen::addPawnMoves(const Board& board, int from, std::vector<Board::Move
     if (fwdRank >= 0 && fwdRank < Board::BOARD_SIZE) {
         int to = Board::toIndex(file, fwdRank);
         if (board.getSquare(to).piece == Board::EMPTY) {
-            // Promotion
-            if (fwdRank == promotionRank) {
+            // Promotion (a push outside `allowed` is skipped, but the double push may still be allowed)
+            if (!Bitboards::testBit(allowed, to)) {
+                // Does not resolve the check, or leaves the pin line
+            } else if (fwdRank == promotionRank) {
                 moves.emplace_back(from, to, Board::QUEEN);
                 moves.emplace_back(from, to, Board::ROOK);
                 moves.emplace_back(from, to, Board::BISHOP);
                 moves.emplace_back(from, to, Board::KNIGHT);
-            } else {
+            } else if (!capturesOnly) {
                 moves.emplace_back(from, to);
             }
             // Double move from starting rank
-            if (rank == startRank) {
+            if (rank == startRank && !capturesOnly) {
                 int dblRank = rank + 2 * direction;
                 int dblTo = Board::toIndex(file, dblRank);
-                if (board.getSquare(dblTo).piece == Board::EMPTY)
+                if (board.getSquare(dblTo).piece == Board::EMPTY && Bitboards::testBit(allowed, dblTo))
                     moves.emplace_back(from, dblTo);
             }
         }
     }
     // Captures to the left and right (including promotion)
-    for (int df = -1; df <= 1; df += 2) {
-        int capFile = file + df;
-        int capRank = rank + direction;
-        if (capFile >= 0 && capFile < Board::BOARD_SIZE && capRank >= 0 && capRank < Board::BOARD_SIZE) {
-            int to = Board::toIndex(capFile, capRank);
-            Board::Square target = board.getSquare(to);
-            if (target.piece != Board::EMPTY && target.colour != pawn.colour) {
-                // Promotion on capture
-                if (capRank == promotionRank) {
-                    moves.emplace_back(from, to, Board::QUEEN);
-                    moves.emplace_back(from, to, Board::ROOK);
-                    moves.emplace_back(from, to, Board::BISHOP);
-                    moves.emplace_back(from, to, Board::KNIGHT);
-                } else {
-                    moves.emplace_back(from, to);
-                }
-            }
+    Board::Colour enemy = (pawn.colour == Board::WHITE) ? Board::BLACK : Board::WHITE;
+    Bitboard captures = Attacks::pawnAttacks(pawn.colour, from) & board.getColourPieces(enemy) & allowed;
+    while (captures) {
+        int to = Bitboards::popLsb(captures);
+        // Promotion on capture
+        if (to / Board::BOARD_SIZE == promotionRank) {
+            moves.emplace_back(from, to, Board::QUEEN);
+            moves.emplace_back(from, to, Board::ROOK);
+            moves.emplace_back(from, to, Board::BISHOP);
+            moves.emplace_back(from, to, Board::KNIGHT);
+        } else {
+            moves.emplace_back(from, to);
         }
     }
     // En passant handled separately
 }
 
-// Helper: Generates all knight moves (L-shaped jumps).
-void MoveGen::addKnightMoves(const Board& board, int from, std::vector<Board::Move>& moves) {
-    int file, rank;
-    Board::indexToCoords(from, file, rank);
-    Board::Square knight = board.getSquare(from);
-
-    for (const auto& offset : knightOffsets) {
-        int toFile = file + offset[0];
-        int toRank = rank + offset[1];
-        if (toFile >= 0 && toFile < Board::BOARD_SIZE && toRank >= 0 && toRank < Board::BOARD_SIZE) {
-            int to = Board::toIndex(toFile, toRank);
-            Board::Square target = board.getSquare(to);
-            if (target.piece == Board::EMPTY || target.colour != knight.colour) {
-                moves.emplace_back(from, to);
-            }
-        }
-    }
+// Helper: Generates all knight moves (L-shaped jumps) from the precomputed attack table.
+void MoveGen::addKnightMoves(int from, MoveList& moves, Bitboard targets) {
+    Bitboard attacks = Attacks::knightAttacks(from) & targets;
+    while (attacks)
+        moves.emplace_back(from, Bitboards::popLsb(attacks));
 }
 
-// Helper: Generates all bishop moves (diagonals).
-void MoveGen::addBishopMoves(const Board& board, int from, std::vector<Board::Move>& moves) {
-    int file, rank;
-    Board::indexToCoords(from, file, rank);
-    Board::Square bishop = board.getSquare(from);
-
-    for (const auto& offset : bishopOffsets) {
-        for (int dist = 1; dist < Board::BOARD_SIZE; ++dist) {
-            int toFile = file + offset[0] * dist;
-            int toRank = rank + offset[1] * dist;
-            if (toFile < 0 || toFile >= Board::BOARD_SIZE || toRank < 0 || toRank >= Board::BOARD_SIZE)
-                break;
-            int to = Board::toIndex(toFile, toRank);
-            Board::Square target = board.getSquare(to);
-            if (target.piece == Board::EMPTY) {
-                moves.emplace_back(from, to);
-            } else {
-                if (target.colour != bishop.colour)
-                    moves.emplace_back(from, to);
-                break; // Blocked by any piece
-            }
-        }
-    }
+// Helper: Generates all bishop moves (diagonals) from the magic attack tables.
+void MoveGen::addBishopMoves(const Board& board, int from, MoveList& moves, Bitboard targets) {
+    Bitboard attacks = Attacks::bishopAttacks(from, board.getOccupancy()) & targets;
+    while (attacks)
+        moves.emplace_back(from, Bitboards::popLsb(attacks));
 }
 
-// Helper: Generates all rook moves (straight lines).
-void MoveGen::addRookMoves(const Board& board, int from, std::vector<Board::Move>& moves) {
-    int file, rank;
-    Board::indexToCoords(from, file, rank);
-    Board::Square rook = board.getSquare(from);
-
-    for (const auto& offset : rookOffsets) {
-        for (int dist = 1; dist < Board::BOARD_SIZE; ++dist) {
-            int toFile = file + offset[0] * dist;
-            int toRank = rank + offset[1] * dist;
-            if (toFile < 0 || toFile >= Board::BOARD_SIZE || toRank < 0 || toRank >= Board::BOARD_SIZE)
-                break;
-            int to = Board::toIndex(toFile, toRank);
-            Board::Square target = board.getSquare(to);
-            if (target.piece == Board::EMPTY) {
-                moves.emplace_back(from, to);
-            } else {
-                if (target.colour != rook.colour)
-                    moves.emplace_back(from, to);
-                break; // Blocked by any piece
-            }
-        }
-    }
+// Helper: Generates all rook moves (straight lines) from the magic attack tables.
+void MoveGen::addRookMoves(const Board& board, int from, MoveList& moves, Bitboard targets) {
+    Bitboard attacks = Attacks::rookAttacks(from, board.getOccupancy()) & targets;
+    while (attacks)
+        moves.emplace_back(from, Bitboards::popLsb(attacks));
 }
 
 // Helper: Generates all queen moves (combines rook and bishop).
-void MoveGen::addQueenMoves(const Board& board, int from, std::vector<Board::Move>& moves) {
-    addBishopMoves(board, from, moves);
-    addRookMoves(board, from, moves);
+void MoveGen::addQueenMoves(const Board& board, int from, MoveList& moves, Bitboard targets) {
+    Bitboard attacks = Attacks::queenAttacks(from, board.getOccupancy()) & targets;
+    while (attacks)
+        moves.emplace_back(from, Bitboards::popLsb(attacks));
 }
 
-// Helper: Generates all king moves (one square in any direction).
-void MoveGen::addKingMoves(const Board& board, int from, std::vector<Board::Move>& moves) {
-    int file, rank;
-    Board::indexToCoords(from, file, rank);
-    Board::Square king = board.getSquare(from);
-
-    for (const auto& offset : kingOffsets) {
-        int toFile = file + offset[0];
-        int toRank = rank + offset[1];
-        if (toFile >= 0 && toFile < Board::BOARD_SIZE && toRank >= 0 && toRank < Board::BOARD_SIZE) {
-            int to = Board::toIndex(toFile, toRank);
-            Board::Square target = board.getSquare(to);
-            if (target.piece == Board::EMPTY || target.colour != king.colour) {
-                moves.emplace_back(from, to);
-            }
-        }
-    }
+// Helper: Generates all king moves (one square in any direction) from the precomputed attack table.
+void MoveGen::addKingMoves(int from, MoveList& moves, Bitboard targets) {
+    Bitboard attacks = Attacks::kingAttacks(from) & targets;
+    while (attacks)
+        moves.emplace_back(from, Bitboards::popLsb(attacks));
     // Castling is handled separately
 }
 
 // Helper: Adds castling moves if the current side has rights and the squares are clear/not attacked.
-void MoveGen::addCastlingMoves(const Board& board, std::vector<Board::Move>& moves) {
+void MoveGen::addCastlingMoves(const Board& board, MoveList& moves) {
     Board::Colour side = board.getSideToMove();
     int rank = (side == Board::WHITE) ? 0 : 7;
     int kingFrom = Board::toIndex(4, rank);
@@ -302,7 +339,7 @@ void MoveGen::addCastlingMoves(const Board& board, std::vector<Board::Move>& mov
 }
 
 // Helper: Adds en passant moves if available.
-void MoveGen::addEnPassantMoves(const Board& board, std::vector<Board::Move>& moves) {
+void MoveGen::addEnPassantMoves(const Board& board, MoveList& moves) {
     int epSq = board.getEnPassantSquare();
     if (epSq == -1) return;
 
@@ -327,139 +364,21 @@ void MoveGen::addEnPassantMoves(const Board& board, std::vector<Board::Move>& mo
 }
 
 // Utility: Checks if a given square is attacked by the opponent.
-// This is a simplified version; more advanced logic can be added for higher Elo.
+// Looks outward from the square (as Board::attackersTo does) and stops at the first kind of attacker
+// found, testing the cheap leaper patterns before the slider lookups.
 bool MoveGen::isSquareAttacked(const Board& board, int square, Board::Colour attacker) {
-    // For each piece of the attacker, generate its attacks and see if any hit the square.
-    for (int sq = 0; sq < Board::NUM_SQUARES; ++sq) {
-        Board::Square piece = board.getSquare(sq);
-        if (piece.colour != attacker || piece.piece == Board::EMPTY)
-            continue;
-        std::vector<Board::Move> tempMoves;
-        switch (piece.piece) {
-            case Board::PAWN: {
-                int file, rank;
-                Board::indexToCoords(sq, file, rank);
-                int direction = (attacker == Board::WHITE) ? 1 : -1;
-                for (int df = -1; df <= 1; df += 2) {
-                    int capFile = file + df;
-                    int capRank = rank + direction;
-                    if (capFile >= 0 && capFile < Board::BOARD_SIZE && capRank >= 0 && capRank < Board::BOARD_SIZE) {
-                        int to = Board::toIndex(capFile, capRank);
-                        if (to == square)
-                            return true;
-                    }
-                }
-                break;
-            }
-            case Board::KNIGHT: {
-                int file, rank;
-                Board::indexToCoords(sq, file, rank);
-                for (const auto& offset : knightOffsets) {
-                    int toFile = file + offset[0];
-                    int toRank = rank + offset[1];
-                    if (toFile >= 0 && toFile < Board::BOARD_SIZE && toRank >= 0 && toRank < Board::BOARD_SIZE) {
-                        int to = Board::toIndex(toFile, toRank);
-                        if (to == square)
-                            return true;
-                    }
-                }
-                break;
-            }
-            case Board::BISHOP: {
-                int file, rank;
-                Board::indexToCoords(sq, file, rank);
-                for (const auto& offset : bishopOffsets) {
-                    for (int dist = 1; dist < Board::BOARD_SIZE; ++dist) {
-                        int toFile = file + offset[0] * dist;
-                        int toRank = rank + offset[1] * dist;
-                        if (toFile < 0 || toFile >= Board::BOARD_SIZE || toRank < 0 || toRank >= Board::BOARD_SIZE)
-                            break;
-                        int to = Board::toIndex(toFile, toRank);
-                        if (to == square)
-                            return true;
-                        if (board.getSquare(to).piece != Board::EMPTY)
-                            break;
-                    }
-                }
-                break;
-            }
-            case Board::ROOK: {
-                int file, rank;
-                Board::indexToCoords(sq, file, rank);
-                for (const auto& offset : rookOffsets) {
-                    for (int dist = 1; dist < Board::BOARD_SIZE; ++dist) {
-                        int toFile = file + offset[0] * dist;
-                        int toRank = rank + offset[1] * dist;
-                        if (toFile < 0 || toFile >= Board::BOARD_SIZE || toRank < 0 || toRank >= Board::BOARD_SIZE)
-                            break;
-                        int to = Board::toIndex(toFile, toRank);
-                        if (to == square)
-                            return true;
-                        if (board.getSquare(to).piece != Board::EMPTY)
-                            break;
-                    }
-                }
-                break;
-            }
-            case Board::QUEEN: {
-                int file, rank;
-                Board::indexToCoords(sq, file, rank);
-                // Bishop directions
-                for (const auto& offset : bishopOffsets) {
-                    for (int dist = 1; dist < Board::BOARD_SIZE; ++dist) {
-                        int toFile = file + offset[0] * dist;
-                        int toRank = rank + offset[1] * dist;
-                        if (toFile < 0 || toFile >= Board::BOARD_SIZE || toRank < 0 || toRank >= Board::BOARD_SIZE)
-                            break;
-                        int to = Board::toIndex(toFile, toRank);
-                        if (to == square)
-                            return true;
-                        if (board.getSquare(to).piece != Board::EMPTY)
-                            break;
-                    }
-                }
-                // Rook directions
-                for (const auto& offset : rookOffsets) {
-                    for (int dist = 1; dist < Board::BOARD_SIZE; ++dist) {
-                        int toFile = file + offset[0] * dist;
-                        int toRank = rank + offset[1] * dist;
-                        if (toFile < 0 || toFile >= Board::BOARD_SIZE || toRank < 0 || toRank >= Board::BOARD_SIZE)
-                            break;
-                        int to = Board::toIndex(toFile, toRank);
-                        if (to == square)
-                            return true;
-                        if (board.getSquare(to).piece != Board::EMPTY)
-                            break;
-                    }
-                }
-                break;
-            }
-            case Board::KING: {
-                int file, rank;
-                Board::indexToCoords(sq, file, rank);
-                for (const auto& offset : kingOffsets) {
-                    int toFile = file + offset[0];
-                    int toRank = rank + offset[1];
-                    if (toFile >= 0 && toFile < Board::BOARD_SIZE && toRank >= 0 && toRank < Board::BOARD_SIZE) {
-                        int to = Board::toIndex(toFile, toRank);
-                        if (to == square)
-                            return true;
-                    }
-                }
-                break;
-            }
-            default: break;
-        }
-    }
-    return false;
+    Board::Colour defender = (attacker == Board::WHITE) ? Board::BLACK : Board::WHITE;
+    Bitboard queens = board.getPieces(attacker, Board::QUEEN);
+
+    return (Attacks::pawnAttacks(defender, square) & board.getPieces(attacker, Board::PAWN))
+        || (Attacks::knightAttacks(square) & board.getPieces(attacker, Board::KNIGHT))
+        || (Attacks::kingAttacks(square) & board.getPieces(attacker, Board::KING))
+        || (Attacks::bishopAttacks(square, board.getOccupancy()) & (board.getPieces(attacker, Board::BISHOP) | queens))
+        || (Attacks::rookAttacks(square, board.getOccupancy()) & (board.getPieces(attacker, Board::ROOK) | queens));
 }
 
 // Utility: Finds the square index of the king for a given colour.
 int MoveGen::findKingSquare(const Board& board, Board::Colour colour) {
-    for (int sq = 0; sq < Board::NUM_SQUARES; ++sq) {
-        Board::Square piece = board.getSquare(sq);
-        if (piece.piece == Board::KING && piece.colour == colour)
-            return sq;
-    }
-    return -1;
+    Bitboard king = board.getPieces(colour, Board::KING);
+    return king ? Bitboards::lsb(king) : -1;
 }
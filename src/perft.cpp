@@ -1,31 +1,137 @@
 #include "perft.h"
+#include "threadpool.h"
 #include <iostream>
+#include <memory>
 
 // Runs a perft test to the specified depth and returns the node count.
-uint64_t Perft::run(const Board& board, int depth) {
+uint64_t Perft::run(const Board& board, int depth, size_t hashMegabytes) {
     uint64_t nodes = 0;
     Board boardCopy = board;
-    perftRecursive(boardCopy, depth, nodes);
+    if (hashMegabytes > 0) {
+        HashTable table(hashMegabytes);
+        perftRecursive(boardCopy, depth, nodes, &table);
+    } else {
+        perftRecursive(boardCopy, depth, nodes);
+    }
+    return nodes;
+}
+
+// Runs perft in parallel, splitting the tree near the root into independent tasks.
+uint64_t Perft::runParallel(const Board& board, int depth, int threads, size_t hashMegabytes) {
+    if (depth < 2 || threads <= 1)
+        return run(board, depth, hashMegabytes);
+
+    std::unique_ptr<HashTable> table;
+    if (hashMegabytes > 0)
+        table = std::make_unique<HashTable>(hashMegabytes);
+    HashTable* sharedTable = table.get();
+
+    ThreadPool pool(threads);
+
+    // One counter per worker, each on its own cache line so the workers do not contend.
+    struct alignas(64) Counter { uint64_t nodes = 0; };
+    std::vector<Counter> counters(pool.size());
+
+    Board root = board;
+    for (const auto& move : MoveGen::generateLegalMoves(root)) {
+        root.makeMove(move);
+
+        if (depth == 2) {
+            // Too shallow to split further: one task per root move.
+            pool.submit([&counters, child = root](int worker) mutable {
+                perftRecursive(child, 1, counters[worker].nodes);
+            });
+        } else {
+            // One task per reply, each with its own copy of the position.
+            for (const auto& reply : MoveGen::generateLegalMoves(root)) {
+                pool.submit([&counters, child = root, reply, depth, sharedTable](int worker) mutable {
+                    child.makeMove(reply);
+                    perftRecursive(child, depth - 2, counters[worker].nodes, sharedTable);
+                });
+            }
+        }
+        root.unmakeMove(move);
+    }
+    pool.wait();
+
+    uint64_t nodes = 0;
+    for (const auto& counter : counters)
+        nodes += counter.nodes;
     return nodes;
 }
 
 // Helper function for recursive perft calculation.
-void Perft::perftRecursive(Board& board, int depth, uint64_t& nodes) {
+void Perft::perftRecursive(Board& board, int depth, uint64_t& nodes, HashTable* table) {
     // Base case: depth 0 (leaf node)
     if (depth == 0) {
         nodes++;
         return;
     }
 
+    // Bulk counting: each legal move at depth 1 leads to exactly one leaf, so the count of legal
+    // moves is the answer and the last ply need not be played.
+    if (depth == 1) {
+        nodes += MoveGen::generateLegalMoves(board).size();
+        return;
+    }
+
+    // A transposition already counted to this depth adds its cached total.
+    uint64_t cached = 0;
+    bool useTable = table != nullptr;
+    if (useTable && table->probe(board.hash(), depth, cached)) {
+        nodes += cached;
+        return;
+    }
+    uint64_t nodesBefore = nodes;
+
     // Generate all legal moves for the current position.
     auto moves = MoveGen::generateLegalMoves(board);
 
-    // For each move, apply it, recurse, then undo (using board copy).
+    // For each move, apply it, recurse, then take it back on the same board.
     for (const auto& move : moves) {
-        Board boardCopy = board; // Copy board so each branch is independent.
-        if (!boardCopy.makeMove(move)) continue; // Skip illegal moves (shouldn't happen with legal moves).
-        perftRecursive(boardCopy, depth - 1, nodes);
+        board.makeMove(move);
+        perftRecursive(board, depth - 1, nodes, table);
+        board.unmakeMove(move);
+    }
+
+    if (useTable)
+        table->store(board.hash(), depth, nodes - nodesBefore);
+}
+
+// Allocates the table, rounding the bucket count down to a power of two.
+Perft::HashTable::HashTable(size_t megabytes) {
+    size_t bytes = megabytes * 1024 * 1024;
+    size_t count = 1;
+    while (count * 2 * sizeof(Bucket) <= bytes)
+        count *= 2;
+    std::vector<Bucket>(count).swap(buckets);
+    bucketMask = count - 1;
+}
+
+// Checks both slots; the depth must match as well as the key.
+bool Perft::HashTable::probe(uint64_t key, int depth, uint64_t& nodes) const {
+    const Bucket& bucket = buckets[key & bucketMask];
+    for (const auto& slot : bucket.slots) {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t check = slot.keyXorData.load(std::memory_order_relaxed);
+        if ((check ^ data) == key && depthOf(data) == depth && data != 0) {
+            nodes = data & ((1ULL << 56) - 1);
+            return true;
+        }
     }
+    return false;
+}
+
+// Writes to the depth-preferred slot if this subtree is at least as deep as the one there,
+// otherwise to the always-replace slot.
+void Perft::HashTable::store(uint64_t key, int depth, uint64_t nodes) {
+    Bucket& bucket = buckets[key & bucketMask];
+    Slot& preferred = bucket.slots[0];
+    Slot& target = (depth >= depthOf(preferred.data.load(std::memory_order_relaxed))) ? preferred : bucket.slots[1];
+
+    uint64_t data = pack(depth, nodes);
+    target.keyXorData.store(key ^ data, std::memory_order_relaxed);
+    target.data.store(data, std::memory_order_relaxed);
 }
 
 // Runs a perft test and provides detailed statistics about move types.
@@ -46,13 +152,11 @@ void Perft::perftRecursiveDetailed(Board& board, int depth, Results& results) {
     auto moves = MoveGen::generateLegalMoves(board);
 
     for (const auto& move : moves) {
-        Board boardCopy = board;
-
         // Save move type stats at root level (depth 1)
         if (depth == 1) {
             // Captures: if destination square contains opponent's piece or en passant
-            auto dest = boardCopy.getSquare(move.to);
-            if ((dest.piece != Board::EMPTY && dest.colour != boardCopy.getSideToMove()) || move.isEnPassant)
+            auto dest = board.getSquare(move.to);
+            if ((dest.piece != Board::EMPTY && dest.colour != board.getSideToMove()) || move.isEnPassant)
                 results.captures++;
 
             // Promotions
@@ -66,23 +170,24 @@ void Perft::perftRecursiveDetailed(Board& board, int depth, Results& results) {
             // En passant
             if (move.isEnPassant)
                 results.enPassants++;
-
-            // Checks
-            Board tempBoard = boardCopy;
-            if (tempBoard.makeMove(move) && isCheck(tempBoard, move))
-                results.checks++;
         }
 
-        if (!boardCopy.makeMove(move)) continue;
-        perftRecursiveDetailed(boardCopy, depth - 1, results);
+        board.makeMove(move);
+
+        // Checks
+        if (depth == 1 && isCheck(board, move))
+            results.checks++;
+
+        perftRecursiveDetailed(board, depth - 1, results);
+        board.unmakeMove(move);
     }
 }
 
 // Utility: Checks if a move delivers check.
-// For 1500 Elo, this is a simple implementation: after the move, is opponent's king attacked?
+// For 1500 Elo, this is a simple implementation: after the move, is the king of the side now to move attacked?
 bool Perft::isCheck(const Board& board, const Board::Move& move) {
-    Board::Colour opponent = (board.getSideToMove() == Board::WHITE) ? Board::BLACK : Board::WHITE;
-    int kingSq = MoveGen::findKingSquare(board, opponent);
+    Board::Colour mover = (board.getSideToMove() == Board::WHITE) ? Board::BLACK : Board::WHITE;
+    int kingSq = MoveGen::findKingSquare(board, board.getSideToMove());
     if (kingSq == -1) return false; // Shouldn't happen in normal chess
-    return MoveGen::isSquareAttacked(board, kingSq, board.getSideToMove());
+    return MoveGen::isSquareAttacked(board, kingSq, mover);
 }
@@ -1,36 +1,223 @@
 #include "search.h"
 #include <algorithm>
 #include <iostream>
+#include <thread>
 
-// Finds the best move for the current position at the given search depth.
+TimeManager Search::timeManager;
+std::atomic<bool> Search::stopRequested{false};
+std::atomic<bool> Search::ponderhitRequested{false};
+std::atomic<bool> Search::searchFinished{false};
+int Search::threadCount = 1;
+std::vector<Search::ThreadData> Search::threads(1);
+thread_local Search::ThreadData* Search::thisThread = &Search::threads[0];
+
+// Lazy SMP depth staggering: helper thread i uses entry (i - 1) % 20 and skips a depth when
+// ((depth + phase) / size) is odd, so that helpers spread over neighbouring depths instead of
+// all searching the same tree in lockstep.
+static constexpr int SKIP_SIZE[20]  = { 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4 };
+static constexpr int SKIP_PHASE[20] = { 0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7 };
+
+// Finds the best move for the current position with iterative deepening.
+// Each iteration searches one ply deeper than the last, starting with the previous best move.
+// Shallow iterations are cheap and fill the transposition table, so the deeper ones order moves well;
+// a usable best move is also available after every completed depth.
+// With a clock, the time manager decides when to stop: no new iteration starts after the soft limit,
+// and a running one is abandoned at the hard limit (keeping the last completed iteration's move).
+// With more than one thread (Lazy SMP), helper threads run the same iterative deepening on their own
+// copies of the position at staggered depths. They share nothing but the transposition table, where
+// their results speed up the other threads. When the main thread finishes, the helpers are stopped
+// and the threads vote on the move to play.
 // Returns the best move and its evaluation score via outScore.
-Board::Move Search::findBestMove(const Board& board, int depth, int& outScore) {
-    Board::Move bestMove(0, 0);
-    int bestScore = std::numeric_limits<int>::min();
+Board::Move Search::findBestMove(const Board& board, int depth, const TimeManager::Limits& limits,
+                                 int& outScore, const InfoCallback& onIteration) {
+    // Search works on one private copy of the position, making and unmaking moves in place.
+    Board root = board;
+
+    // Age the transposition table so results from earlier searches are replaced first.
+    TT.newSearch();
+    timeManager.start(limits, root.getSideToMove());
+    depth = std::min(depth, MAX_PLY - 1);
 
     // Generate all legal moves for the side to move.
-    auto moves = MoveGen::generateLegalMoves(board);
+    auto moves = MoveGen::generateLegalMoves(root);
     if (moves.empty()) {
-        outScore = Evaluate::score(board);
-        return bestMove;
+        outScore = checkGameOver(root, 0);
+        return Board::Move(0, 0);
+    }
+
+    // Initial ordering (hash move, then captures, then others).
+    TranspositionTable::Entry ttEntry;
+    Board::Move ttMove = TT.probe(root.hash(), ttEntry) ? ttEntry.move : Board::Move(0, 0);
+    orderMoves(root, moves, ttMove);
+
+    // Reset the per-thread search state; until a depth completes, every thread's answer is the first ordered move.
+    // The threads' data is only rebuilt when the thread count changes, so their pawn tables carry over between moves.
+    if (threads.size() != static_cast<size_t>(threadCount))
+        std::vector<ThreadData>(threadCount).swap(threads);
+    for (auto& thread : threads) {
+        thread.nodes.store(0, std::memory_order_relaxed);
+        thread.stopped = false;
+        thread.bestMove = moves.front();
+        thread.score = 0;
+        thread.completedDepth = 0;
+    }
+    searchFinished.store(false, std::memory_order_relaxed);
+
+    // Each helper gets its own copy of the position, taken here before the main thread starts moving pieces.
+    std::vector<std::thread> helpers;
+    for (int i = 1; i < threadCount; ++i) {
+        helpers.emplace_back([i, depth, moves, helperRoot = root]() mutable {
+            thisThread = &threads[i];
+            iterativeDeepening(helperRoot, moves, depth, i, nullptr);
+        });
+    }
+
+    thisThread = &threads[0];
+    iterativeDeepening(root, moves, depth, 0, &onIteration);
+
+    // The main thread decides when the search ends.
+    searchFinished.store(true, std::memory_order_relaxed);
+    for (auto& helper : helpers)
+        helper.join();
+
+    return voteBestMove(outScore);
+}
+
+// Iterative deepening for one thread. The main thread (index 0) searches every depth, reports
+// progress and watches the clock; helpers skip depths according to SKIP_SIZE/SKIP_PHASE.
+// Each completed depth's result is recorded in the thread's ThreadData.
+void Search::iterativeDeepening(Board& root, MoveList moves, int depth, int threadIndex,
+                                const InfoCallback* onIteration) {
+    ThreadData& thread = *thisThread;
+    int stableIterations = 0;
+
+    for (int currentDepth = 1; currentDepth <= depth; ++currentDepth) {
+        if (threadIndex > 0) {
+            int k = (threadIndex - 1) % 20;
+            if (((currentDepth + SKIP_PHASE[k]) / SKIP_SIZE[k]) % 2)
+                continue;
+        }
+
+        int score = 0;
+        Board::Move move = searchRoot(root, moves, currentDepth, score);
+        if (thread.stopped)
+            break; // Stopped part-way through: this iteration's result is incomplete
+
+        stableIterations = sameMove(move, thread.bestMove) ? stableIterations + 1 : 0;
+        thread.bestMove = move;
+        thread.score = score;
+        thread.completedDepth = currentDepth;
+
+        // Move this iteration's best move to the front so the next iteration searches it first;
+        // the remaining moves keep their relative order.
+        auto it = std::find_if(moves.begin(), moves.end(), [&](const Board::Move& m) { return sameMove(m, move); });
+        std::rotate(moves.begin(), it, it + 1);
+
+        if (threadIndex > 0)
+            continue;
+
+        if (onIteration && *onIteration) {
+            SearchInfo info;
+            info.depth = currentDepth;
+            info.score = score;
+            info.bestMove = move;
+            info.nodes = totalNodes();
+            info.timeMs = timeManager.elapsedMs();
+            (*onIteration)(info);
+        }
+
+        // Starting another iteration now would likely not finish before the deadline.
+        checkTime();
+        if (thread.stopped || timeManager.softLimitReached(stableIterations))
+            break;
+    }
+}
+
+// Combines the threads' results. Each thread votes for its best move with a weight that grows with
+// both its score (relative to the worst score reported) and the depth it completed, so a deep
+// thread that found a clearly better move can overrule the main thread.
+Board::Move Search::voteBestMove(int& outScore) {
+    int minScore = INFINITE_SCORE;
+    for (const auto& thread : threads)
+        if (thread.completedDepth > 0)
+            minScore = std::min(minScore, thread.score);
+
+    std::vector<std::pair<Board::Move, int64_t>> votes;
+    for (const auto& thread : threads) {
+        if (thread.completedDepth == 0) continue;
+        auto it = std::find_if(votes.begin(), votes.end(), [&](const std::pair<Board::Move, int64_t>& v) {
+            return sameMove(v.first, thread.bestMove);
+        });
+        if (it == votes.end())
+            it = votes.insert(votes.end(), { thread.bestMove, 0 });
+        it->second += static_cast<int64_t>(thread.score - minScore + 14) * thread.completedDepth;
+    }
+
+    // No depth completed at all: fall back to the main thread's first ordered move.
+    if (votes.empty()) {
+        outScore = 0;
+        return threads[0].bestMove;
+    }
+
+    auto winner = std::max_element(votes.begin(), votes.end(),
+        [](const std::pair<Board::Move, int64_t>& a, const std::pair<Board::Move, int64_t>& b) {
+            return a.second < b.second;
+        });
+
+    // Report the score of the deepest thread that chose the winning move.
+    const ThreadData* best = nullptr;
+    for (const auto& thread : threads) {
+        if (thread.completedDepth > 0 && sameMove(thread.bestMove, winner->first)
+            && (!best || thread.completedDepth > best->completedDepth))
+            best = &thread;
     }
+    outScore = best->score;
+    return best->bestMove;
+}
+
+// Fixed-depth search: no clock limits.
+Board::Move Search::findBestMove(const Board& board, int depth, int& outScore, const InfoCallback& onIteration) {
+    return findBestMove(board, depth, TimeManager::Limits(), outScore, onIteration);
+}
 
-    // Order moves (captures first, then others) for efficiency.
-    moves = orderMoves(board, moves);
+// Searches all root moves to a fixed depth with principal variation search:
+// the first (expected best) move gets the full window, the rest a null window around alpha.
+Board::Move Search::searchRoot(Board& board, const MoveList& moves, int depth, int& outScore) {
+    int alpha = -INFINITE_SCORE;
+    int beta = INFINITE_SCORE;
+    int bestScore = -INFINITE_SCORE;
+    Board::Move bestMove = moves.front();
+    bool firstMove = true;
 
-    // Try all moves and choose the one with the highest score.
     for (const auto& move : moves) {
-        Board boardCopy = board;
-        if (!boardCopy.makeMove(move)) continue;
+        board.makeMove(move);
 
-        int score = minimax(boardCopy, depth - 1, std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), false);
+        int score;
+        if (firstMove) {
+            score = -negamax(board, depth - 1, -beta, -alpha, 1);
+        } else {
+            // Prove the move is no better than the current best; re-search only if it is.
+            score = -negamax(board, depth - 1, -alpha - 1, -alpha, 1);
+            if (score > alpha && score < beta)
+                score = -negamax(board, depth - 1, -beta, -alpha, 1);
+        }
+        board.unmakeMove(move);
+        firstMove = false;
+        if (thisThread->stopped)
+            break;
 
         if (score > bestScore) {
             bestScore = score;
             bestMove = move;
+            alpha = std::max(alpha, score);
         }
     }
 
+    if (thisThread->stopped)
+        return bestMove;
+
+    TT.store(board.hash(), bestMove, scoreToTT(bestScore, 0), depth, TranspositionTable::BOUND_EXACT);
+
     outScore = bestScore;
     return bestMove;
 }
@@ -41,57 +228,235 @@ Board::Move Search::findBestMove(const Board& board, int depth) {
     return findBestMove(board, depth, dummyScore);
 }
 
-// Core minimax search with alpha-beta pruning.
-// Maximising for White, minimising for Black.
-int Search::minimax(Board& board, int depth, int alpha, int beta, bool maximisingPlayer) {
-    // Base case: leaf node (depth 0) or game over.
-    if (depth == 0 || board.isGameOver()) {
-        return Evaluate::score(board);
+// Core negamax search with principal variation search (PVS).
+// Every score is from the side to move's point of view, so a child's score is negated for its parent
+// and a single code path serves both colours. The first move is searched with the full (alpha, beta)
+// window; later moves are searched with a null window (alpha, alpha + 1), which is much cheaper and
+// only proves they are not better. A move that fails high is re-searched with the full window.
+int Search::negamax(Board& board, int depth, int alpha, int beta, int ply) {
+    // Horizon: resolve pending captures before evaluating (quiescence counts the node itself).
+    if (depth <= 0)
+        return quiescence(board, alpha, beta, ply);
+
+    countNode();
+    if (thisThread->stopped)
+        return 0; // The result is discarded by findBestMove
+
+    // Base case: game over or search too deep.
+    if (board.isGameOver() || ply >= MAX_PLY) {
+        return evaluateRelative(board);
+    }
+
+    // Probe the transposition table: a result at least as deep for this position can end the search
+    // at null-window nodes, and its best move is tried first either way.
+    bool pvNode = (beta - alpha > 1);
+    int alphaOrig = alpha;
+    TranspositionTable::Entry ttEntry;
+    Board::Move ttMove(0, 0);
+    if (TT.probe(board.hash(), ttEntry)) {
+        ttMove = ttEntry.move;
+        int ttScore = scoreFromTT(ttEntry.score, ply);
+        if (!pvNode && ttEntry.depth >= depth) {
+            if (ttEntry.bound == TranspositionTable::BOUND_EXACT)
+                return ttScore;
+            if (ttEntry.bound == TranspositionTable::BOUND_LOWER && ttScore >= beta)
+                return ttScore;
+            if (ttEntry.bound == TranspositionTable::BOUND_UPPER && ttScore <= alpha)
+                return ttScore;
+        }
     }
 
     auto moves = MoveGen::generateLegalMoves(board);
     if (moves.empty()) {
         // No legal moves: checkmate or stalemate.
-        return checkGameOver(board, depth);
+        return checkGameOver(board, ply);
     }
 
     // Order moves for efficiency.
-    moves = orderMoves(board, moves);
-
-    if (maximisingPlayer) {
-        int maxEval = std::numeric_limits<int>::min();
-        for (const auto& move : moves) {
-            Board boardCopy = board;
-            if (!boardCopy.makeMove(move)) continue;
-            int eval = minimax(boardCopy, depth - 1, alpha, beta, false);
-            maxEval = std::max(maxEval, eval);
-            alpha = std::max(alpha, eval);
-            if (beta <= alpha)
-                break; // Beta cut-off
+    orderMoves(board, moves, ttMove);
+
+    int bestScore = -INFINITE_SCORE;
+    Board::Move bestMove(0, 0);
+    bool firstMove = true;
+    for (const auto& move : moves) {
+        board.makeMove(move);
+
+        int score;
+        if (firstMove) {
+            score = -negamax(board, depth - 1, -beta, -alpha, ply + 1);
+        } else {
+            score = -negamax(board, depth - 1, -alpha - 1, -alpha, ply + 1);
+            if (score > alpha && score < beta)
+                score = -negamax(board, depth - 1, -beta, -alpha, ply + 1);
+        }
+        board.unmakeMove(move);
+        firstMove = false;
+        if (thisThread->stopped)
+            return 0;
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = move;
+            if (score > alpha) {
+                alpha = score;
+                if (alpha >= beta)
+                    break; // Beta cut-off
+            }
+        }
+    }
+
+    // Record the result. Scores outside the original window are only bounds on the true value.
+    TranspositionTable::Bound bound = TranspositionTable::BOUND_EXACT;
+    if (bestScore <= alphaOrig)
+        bound = TranspositionTable::BOUND_UPPER;
+    else if (bestScore >= beta)
+        bound = TranspositionTable::BOUND_LOWER;
+    TT.store(board.hash(), bestMove, scoreToTT(bestScore, ply), depth, bound);
+
+    return bestScore;
+}
+
+// Quiescence search over captures and promotions.
+// The side to move may "stand pat" (accept the static evaluation) rather than capture, since in
+// almost every position some quiet move is at least as good. Captures are then tried in MVV/LVA order
+// until one raises the score past beta or none remain. Captures that cannot possibly reach alpha,
+// even winning the captured piece with a margin to spare, are skipped (delta pruning).
+// A side in check cannot stand pat: every evasion is searched instead, and having none is mate.
+int Search::quiescence(Board& board, int alpha, int beta, int ply) {
+    countNode();
+    if (thisThread->stopped)
+        return 0;
+
+    if (ply >= MAX_PLY)
+        return evaluateRelative(board);
+
+    Board::Colour us = board.getSideToMove();
+    Board::Colour them = (us == Board::WHITE) ? Board::BLACK : Board::WHITE;
+    bool inCheck = MoveGen::isSquareAttacked(board, MoveGen::findKingSquare(board, us), them);
+
+    int standPat = 0;
+    int bestScore = -MATE_SCORE + ply; // Mated unless an evasion is found
+    if (!inCheck) {
+        standPat = evaluateRelative(board);
+
+        // Stand pat: the static score is already good enough to refute the previous move.
+        if (standPat >= beta)
+            return standPat;
+
+        // Delta pruning: if winning a queen would not bring the score up to alpha, no capture can.
+        // The bound returned is the most a capture could have reached, not the static score, so that the
+        // fail-low score does not depend on which moves happened to be pruned.
+        if (standPat + Evaluate::getMaterialValue(Board::QUEEN) + DELTA_MARGIN < alpha)
+            return standPat + Evaluate::getMaterialValue(Board::QUEEN) + DELTA_MARGIN;
+
+        if (standPat > alpha)
+            alpha = standPat;
+        bestScore = standPat;
+    }
+
+    auto moves = inCheck ? MoveGen::generateLegalMoves(board) : MoveGen::generateLegalCaptures(board);
+    orderMoves(board, moves, Board::Move(0, 0));
+
+    for (const auto& move : moves) {
+        // Delta pruning per move (promotions are always searched, as they gain material themselves).
+        if (!inCheck && move.promotion == Board::EMPTY) {
+            Board::Piece captured = move.isEnPassant ? Board::PAWN : board.getSquare(move.to).piece;
+            int optimistic = standPat + Evaluate::getMaterialValue(captured) + DELTA_MARGIN;
+            if (optimistic <= alpha) {
+                bestScore = std::max(bestScore, optimistic); // The pruned capture could have scored this much
+                continue;
+            }
         }
-        return maxEval;
-    } else {
-        int minEval = std::numeric_limits<int>::max();
-        for (const auto& move : moves) {
-            Board boardCopy = board;
-            if (!boardCopy.makeMove(move)) continue;
-            int eval = minimax(boardCopy, depth - 1, alpha, beta, true);
-            minEval = std::min(minEval, eval);
-            beta = std::min(beta, eval);
-            if (beta <= alpha)
-                break; // Alpha cut-off
+
+        board.makeMove(move);
+        int score = -quiescence(board, -beta, -alpha, ply + 1);
+        board.unmakeMove(move);
+        if (thisThread->stopped)
+            return 0;
+
+        if (score > bestScore) {
+            bestScore = score;
+            if (score > alpha) {
+                alpha = score;
+                if (alpha >= beta)
+                    break; // Beta cut-off
+            }
         }
-        return minEval;
     }
+
+    return bestScore;
+}
+
+// Clears stop and ponderhit requests left over from the previous search.
+void Search::resetSignals() {
+    stopRequested.store(false, std::memory_order_relaxed);
+    ponderhitRequested.store(false, std::memory_order_relaxed);
+}
+
+// Asks the running search to stop. The flag is polled at every node, so this takes effect within microseconds.
+void Search::stop() {
+    stopRequested.store(true, std::memory_order_relaxed);
+}
+
+// Passes a ponderhit to the search thread, which restarts its clock at the next time check.
+void Search::ponderhit() {
+    ponderhitRequested.store(true, std::memory_order_relaxed);
+}
+
+// Sets the number of search threads used by the next search (clamped to 1..MAX_THREADS).
+// Must not be called while a search is running.
+void Search::setThreadCount(int count) {
+    threadCount = std::max(1, std::min(MAX_THREADS, count));
+}
+
+// Counts a node. The stop flags are relaxed loads and are checked every time;
+// the clock is only read occasionally (and only by the main thread) since that is comparatively slow.
+void Search::countNode() {
+    ThreadData& thread = *thisThread;
+    uint64_t count = thread.nodes.load(std::memory_order_relaxed) + 1;
+    thread.nodes.store(count, std::memory_order_relaxed); // Only this thread writes its counter
+
+    if (stopRequested.load(std::memory_order_relaxed) || searchFinished.load(std::memory_order_relaxed))
+        thread.stopped = true;
+    else if (&thread == &threads[0] && (count & (TIME_CHECK_INTERVAL - 1)) == 0)
+        checkTime();
+}
+
+// Sums the node counters of every thread.
+uint64_t Search::totalNodes() {
+    uint64_t total = 0;
+    for (const auto& thread : threads)
+        total += thread.nodes.load(std::memory_order_relaxed);
+    return total;
+}
+
+// Starts the clock of a pondering search once the GUI reports a ponderhit, then checks the hard deadline.
+void Search::checkTime() {
+    if (ponderhitRequested.exchange(false, std::memory_order_relaxed))
+        timeManager.ponderhit();
+    if (stopRequested.load(std::memory_order_relaxed) || timeManager.hardLimitReached())
+        thisThread->stopped = true;
 }
 
 // Orders moves for search efficiency (MVV/LVA: Most Valuable Victim / Least Valuable Attacker).
-// Captures and promotions are prioritised.
-std::vector<Board::Move> Search::orderMoves(const Board& board, const std::vector<Board::Move>& moves) {
-    std::vector<std::pair<int, Board::Move>> scoredMoves;
+// The hash move from the transposition table comes first; captures and promotions are prioritised next.
+// The scored moves are kept in a fixed array on the stack and the list is rewritten in place,
+// so ordering needs no allocation.
+void Search::orderMoves(const Board& board, MoveList& moves, const Board::Move& ttMove) {
+    struct ScoredMove {
+        int score;
+        Board::Move move;
+    };
+    ScoredMove scoredMoves[MoveList::MAX_MOVES]; // Left uninitialised; only the first `count` are used
+    size_t count = 0;
 
     for (const auto& move : moves) {
         int score = 0;
+        if (sameMove(move, ttMove)) {
+            // Best move from an earlier search of this position: try it before anything else.
+            scoredMoves[count++] = { std::numeric_limits<int>::max(), move };
+            continue;
+        }
         Board::Square target = board.getSquare(move.to);
         if (target.piece != Board::EMPTY) {
             // Capture: prioritise based on value of captured piece.
@@ -109,40 +474,56 @@ std::vector<Board::Move> Search::orderMoves(const Board& board, const std::vecto
         if (move.isEnPassant) {
             score += 100;
         }
-        scoredMoves.emplace_back(score, move);
+        scoredMoves[count++] = { score, move };
     }
 
     // Sort moves by descending score.
-    std::sort(scoredMoves.begin(), scoredMoves.end(),
-              [](const std::pair<int, Board::Move>& a, const std::pair<int, Board::Move>& b) {
-                  return a.first > b.first;
-              });
+    std::sort(scoredMoves, scoredMoves + count, [](const ScoredMove& a, const ScoredMove& b) {
+        return a.score > b.score;
+    });
 
-    // Return moves in sorted order.
-    std::vector<Board::Move> ordered;
-    for (const auto& p : scoredMoves) {
-        ordered.push_back(p.second);
-    }
-    return ordered;
+    // Write the moves back in sorted order.
+    for (size_t i = 0; i < count; ++i)
+        moves[i] = scoredMoves[i].move;
+}
+
+// Compares the squares and promotion of two moves.
+bool Search::sameMove(const Board::Move& a, const Board::Move& b) {
+    return a.from == b.from && a.to == b.to && a.promotion == b.promotion;
 }
 
-// Returns mate or stalemate scores for game-over states.
+// Returns mate or stalemate scores for a position with no legal moves.
+// Mate is scored relative to the root so that shorter mates are preferred (and longer defences chosen when losing).
 int Search::checkGameOver(const Board& board, int ply) {
-    // For now, simply return a large negative value for checkmate, zero for stalemate.
-    // This can be improved for more nuanced behaviour.
-    auto moves = MoveGen::generateLegalMoves(board);
-    if (moves.empty()) {
-        // If king is in check, it's mate.
-        Board::Colour opponent = (board.getSideToMove() == Board::WHITE) ? Board::BLACK : Board::WHITE;
-        int kingSq = MoveGen::findKingSquare(board, board.getSideToMove());
-        if (MoveGen::isSquareAttacked(board, kingSq, opponent)) {
-            // Mate: losing side gets negative score, positive for winning side.
-            int mateScore = -100000 + ply;
-            return mateScore;
-        } else {
-            // Stalemate: draw.
-            return 0;
-        }
+    // If king is in check, it's mate.
+    Board::Colour opponent = (board.getSideToMove() == Board::WHITE) ? Board::BLACK : Board::WHITE;
+    int kingSq = MoveGen::findKingSquare(board, board.getSideToMove());
+    if (kingSq < 0)
+        return 0; // No king (a malformed position): nothing to mate
+    if (MoveGen::isSquareAttacked(board, kingSq, opponent)) {
+        // Mate: the side to move has lost.
+        return -MATE_SCORE + ply;
     }
-    return Evaluate::score(board);
+    // Stalemate: draw.
+    return 0;
+}
+
+// Returns the static evaluation from the side to move's point of view (Evaluate scores are White-relative).
+int Search::evaluateRelative(const Board& board) {
+    int score = Evaluate::score(board, thisThread->pawnTable);
+    return board.getSideToMove() == Board::WHITE ? score : -score;
+}
+
+// Mate scores are stored in the TT as distance from the stored node, so they stay correct
+// when the same position is reached at a different ply.
+int Search::scoreToTT(int score, int ply) {
+    if (score >= MATE_BOUND) return score + ply;
+    if (score <= -MATE_BOUND) return score - ply;
+    return score;
+}
+
+int Search::scoreFromTT(int score, int ply) {
+    if (score >= MATE_BOUND) return score - ply;
+    if (score <= -MATE_BOUND) return score + ply;
+    return score;
 }
@@ -0,0 +1,87 @@
+#include "threadpool.h"
+#include <algorithm>
+
+// Creates one queue per worker, then starts the workers.
+ThreadPool::ThreadPool(int threads) {
+    int count = std::max(1, threads);
+    for (int i = 0; i < count; ++i)
+        queues.push_back(std::make_unique<Queue>());
+    for (int i = 0; i < count; ++i)
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+// Lets the workers drain their queues, then joins them.
+ThreadPool::~ThreadPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        quit = true;
+    }
+    taskAvailable.notify_all();
+    for (auto& worker : workers)
+        worker.join();
+}
+
+// Deals the task to the next queue in turn and wakes an idle worker.
+void ThreadPool::submit(Task task) {
+    unfinished.fetch_add(1);
+    Queue& queue = *queues[nextQueue.fetch_add(1) % queues.size()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    {
+        // Taking the state lock orders this with a worker checking `queued` before it sleeps.
+        std::lock_guard<std::mutex> lock(stateMutex);
+        queued.fetch_add(1);
+    }
+    taskAvailable.notify_one();
+}
+
+// Waits for the count of unfinished tasks to reach zero.
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(stateMutex);
+    allDone.wait(lock, [this]() { return unfinished.load() == 0; });
+}
+
+// Runs tasks until the pool shuts down, sleeping while there is nothing to do.
+void ThreadPool::workerLoop(int index) {
+    while (true) {
+        Task task;
+        if (popTask(index, task)) {
+            task(index);
+            if (unfinished.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                allDone.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(stateMutex);
+        taskAvailable.wait(lock, [this]() { return quit || queued.load() > 0; });
+        if (quit && queued.load() == 0)
+            return;
+    }
+}
+
+// Own queue first (newest task, whose data is most likely still in cache), then the oldest
+// task of each other queue, starting with the next worker along.
+bool ThreadPool::popTask(int index, Task& task) {
+    int count = static_cast<int>(queues.size());
+    for (int i = 0; i < count; ++i) {
+        Queue& queue = *queues[(index + i) % count];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty())
+            continue;
+        if (i == 0) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        } else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        queued.fetch_sub(1);
+        return true;
+    }
+    return false;
+}
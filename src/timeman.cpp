@@ -0,0 +1,64 @@
+#include "timeman.h"
+#include <algorithm>
+
+// Computes the soft and hard deadlines for this move.
+// With a fixed move time both deadlines are that time (less the overhead).
+// Otherwise the remaining time is shared over the moves left to the time control, with most of the
+// increment added on top. The hard limit allows a few times the soft limit so an unfinished iteration
+// can still complete, but never more than a fraction of the remaining clock.
+void TimeManager::start(const Limits& limits, Board::Colour side) {
+    startTime = std::chrono::steady_clock::now();
+
+    // No deadline until told to stop (or, when pondering, until ponderhit).
+    pondering = limits.ponder;
+    if (limits.infinite || limits.ponder) {
+        pendingLimits = limits;
+        pendingSide = side;
+        active = false;
+        return;
+    }
+
+    int time = (side == Board::WHITE) ? limits.wtime : limits.btime;
+    int inc = (side == Board::WHITE) ? limits.winc : limits.binc;
+
+    if (limits.movetime >= 0) {
+        active = true;
+        softLimitMs = hardLimitMs = std::max(1, limits.movetime - MOVE_OVERHEAD_MS);
+        return;
+    }
+
+    if (time < 0) {
+        // No clock given: only the depth limit applies.
+        active = false;
+        return;
+    }
+
+    active = true;
+    int available = std::max(1, time - MOVE_OVERHEAD_MS);
+    int movesToGo = (limits.movestogo > 0) ? std::min(limits.movestogo, 50) : DEFAULT_MOVES_TO_GO;
+
+    int soft = available / movesToGo + inc * 3 / 4;
+    hardLimitMs = std::max(1, std::min(soft * 4, available * 4 / 5));
+    softLimitMs = std::min(soft, hardLimitMs);
+}
+
+// Switches a pondering search to a normal timed one.
+void TimeManager::ponderhit() {
+    if (!pondering) return;
+    Limits limits = pendingLimits;
+    limits.ponder = false;
+    start(limits, pendingSide);
+}
+
+// Milliseconds since the search started.
+int TimeManager::elapsedMs() const {
+    return static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime).count());
+}
+
+// Checked between iterations: a stable best move lets the search finish at half the soft limit.
+bool TimeManager::softLimitReached(int stableIterations) const {
+    if (!active) return false;
+    int limit = (stableIterations >= STABLE_ITERATIONS) ? softLimitMs / 2 : softLimitMs;
+    return elapsedMs() >= limit;
+}
@@ -0,0 +1,136 @@
+#include "tt.h"
+#include <algorithm>
+#include <climits>
+#include <new>
+
+TranspositionTable TT;
+
+// Constructor: allocates the table at the requested size
+TranspositionTable::TranspositionTable(size_t megabytes) {
+    resize(megabytes);
+}
+
+// Reallocates the table, rounding the bucket count down to a power of two so a mask selects the bucket
+bool TranspositionTable::resize(size_t megabytes) {
+    size_t bytes = (megabytes ? megabytes : 1) * 1024 * 1024;
+    size_t count = 1;
+    while (count * 2 * sizeof(Bucket) <= bytes)
+        count *= 2;
+
+    size_t previousCount = buckets.size();
+    bool allocated = true;
+    std::vector<Bucket>().swap(buckets); // Release the old table before allocating the new one
+    try {
+        std::vector<Bucket>(count).swap(buckets);
+    } catch (const std::bad_alloc&) {
+        // Fall back to the size the table had before (the memory was only just released)
+        allocated = false;
+        count = std::max<size_t>(previousCount, 1);
+        std::vector<Bucket>(count).swap(buckets);
+    }
+    bucketMask = count - 1;
+    generation = 0;
+    return allocated;
+}
+
+// Empties every entry
+void TranspositionTable::clear() {
+    for (auto& bucket : buckets) {
+        for (auto& slot : bucket.slots) {
+            slot.keyXorData.store(0, std::memory_order_relaxed);
+            slot.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    generation = 0;
+}
+
+// Ages every existing entry by one search
+void TranspositionTable::newSearch() {
+    generation = (generation + 1) & GENERATION_MASK;
+}
+
+// Looks up a position; the XOR check rejects both other positions and half-written entries
+bool TranspositionTable::probe(uint64_t key, Entry& entry) const {
+    const Bucket& bucket = bucketFor(key);
+    for (const auto& slot : bucket.slots) {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t check = slot.keyXorData.load(std::memory_order_relaxed);
+        if ((check ^ data) == key && data != 0) {
+            entry = unpack(data);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Stores a result. An existing entry for the same position is updated in place (keeping its move if
+// the new result has none, and keeping a much deeper result from this search unless the new one is exact).
+// Otherwise the entry with the lowest depth, penalised by how many searches ago it was written, is replaced.
+void TranspositionTable::store(uint64_t key, const Board::Move& move, int score, int depth, Bound bound) {
+    Bucket& bucket = bucketFor(key);
+    Slot* target = nullptr;
+    Board::Move bestMove = move;
+    int worstValue = INT_MAX;
+
+    for (auto& slot : bucket.slots) {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t check = slot.keyXorData.load(std::memory_order_relaxed);
+
+        if (data != 0 && (check ^ data) == key) {
+            if (bound != BOUND_EXACT && generationOf(data) == generation && depth < depthOf(data) - 2)
+                return;
+            if (move.from == move.to)
+                bestMove = unpack(data).move;
+            target = &slot;
+            break;
+        }
+
+        // Empty slots are always the first choice
+        int value = INT_MIN;
+        if (data != 0) {
+            int age = (generation - generationOf(data)) & GENERATION_MASK;
+            value = depthOf(data) - 8 * age;
+        }
+        if (value < worstValue) {
+            worstValue = value;
+            target = &slot;
+        }
+    }
+
+    uint64_t data = pack(bestMove, score, depth, bound, generation);
+    target->keyXorData.store(key ^ data, std::memory_order_relaxed);
+    target->data.store(data, std::memory_order_relaxed);
+}
+
+// Samples the first thousand entries to estimate how full the table is
+int TranspositionTable::hashfull() const {
+    int used = 0;
+    size_t sampleBuckets = std::min<size_t>(buckets.size(), 1000 / ENTRIES_PER_BUCKET);
+    for (size_t i = 0; i < sampleBuckets; ++i) {
+        for (const auto& slot : buckets[i].slots) {
+            uint64_t data = slot.data.load(std::memory_order_relaxed);
+            if (data != 0 && generationOf(data) == generation)
+                used++;
+        }
+    }
+    return static_cast<int>(used * 1000 / (sampleBuckets * ENTRIES_PER_BUCKET));
+}
+
+// Packs an entry into one 64-bit word (the move in its 16-bit Board::PackedMove form).
+uint64_t TranspositionTable::pack(const Board::Move& move, int score, int depth, Bound bound, uint8_t gen) {
+    return static_cast<uint64_t>(Board::PackedMove(move).raw())
+         | (static_cast<uint64_t>(static_cast<uint32_t>(score)) << 16)
+         | (static_cast<uint64_t>(static_cast<uint8_t>(depth)) << 48)
+         | (static_cast<uint64_t>(bound) << 56)
+         | (static_cast<uint64_t>(gen & GENERATION_MASK) << 58);
+}
+
+// Unpacks a 64-bit word into an entry
+TranspositionTable::Entry TranspositionTable::unpack(uint64_t data) {
+    Entry entry;
+    entry.move = Board::PackedMove(static_cast<uint16_t>(data & 0xFFFF)).unpack();
+    entry.score = static_cast<int32_t>(static_cast<uint32_t>(data >> 16));
+    entry.depth = depthOf(data);
+    entry.bound = static_cast<Bound>((data >> 56) & 0x3);
+    return entry;
+}
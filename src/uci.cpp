@@ -1,7 +1,10 @@
 #include "uci.h"
+#include "attacks.h"
+#include "tt.h"
+#include "utils.h"
 #include <iostream>
 #include <sstream>
-#include <chrono>
+#include <algorithm>
 
 // Splits a string into tokens using spaces (for command parsing).
 std::vector<std::string> UCI::split(const std::string& s) {
@@ -13,54 +16,117 @@ std::vector<std::string> UCI::split(const std::string& s) {
     return tokens;
 }
 
+// Makes sure the search thread has finished before the UCI object goes away.
+UCI::~UCI() {
+    stopSearch();
+}
+
 // Starts the UCI command loop.
 // This loop reads lines from stdin and responds to UCI protocol commands.
-// You can add more commands or options for further engine features.
 void UCI::run() {
     std::string line;
 
     std::cout << "UCI protocol handler started. Waiting for commands...\n";
 
     while (std::getline(std::cin, line)) {
-        auto tokens = split(line);
-
-        if (tokens.empty()) continue;
-
-        if (tokens[0] == "uci") {
-            handleUci();
-        } else if (tokens[0] == "isready") {
-            handleIsReady();
-        } else if (tokens[0] == "ucinewgame") {
-            handleUciNewGame();
-        } else if (tokens[0] == "position") {
-            handlePosition(tokens);
-        } else if (tokens[0] == "go") {
-            handleGo(tokens);
-        } else if (tokens[0] == "stop") {
-            handleStop();
-        } else if (tokens[0] == "quit") {
-            handleQuit();
+        if (!execute(line))
             break;
-        }
-        // You can add more commands here (setoption, ponderhit etc.)
     }
+    // End of input (or "quit"): do not leave a search running.
+    stopSearch();
+}
+
+// Handles a single UCI command line. Returns false once "quit" has been received.
+// You can add more commands or options for further engine features.
+bool UCI::execute(const std::string& line) {
+    auto tokens = split(line);
+
+    if (tokens.empty()) return true;
+
+    if (tokens[0] == "uci") {
+        handleUci();
+    } else if (tokens[0] == "isready") {
+        handleIsReady();
+    } else if (tokens[0] == "ucinewgame") {
+        handleUciNewGame();
+    } else if (tokens[0] == "setoption") {
+        handleSetOption(tokens);
+    } else if (tokens[0] == "position") {
+        handlePosition(tokens);
+    } else if (tokens[0] == "go") {
+        handleGo(tokens);
+    } else if (tokens[0] == "stop") {
+        handleStop();
+    } else if (tokens[0] == "ponderhit") {
+        handlePonderHit();
+    } else if (tokens[0] == "quit") {
+        handleQuit();
+        return false;
+    }
+    // You can add more commands here (debug, register etc.)
+    return true;
 }
 
 // UCI "uci" command: print engine name and author.
 void UCI::handleUci() {
     std::cout << "id name Oliviathan\n";
     std::cout << "id author MaskedOlive\n";
+    // Engine options
+    std::cout << "option name Hash type spin default " << TranspositionTable::DEFAULT_SIZE_MB
+              << " min 1 max 65536\n";
+    std::cout << "option name Threads type spin default 1 min 1 max " << Search::MAX_THREADS << "\n";
+    std::cout << "option name SliderAttacks type combo default "
+              << (Attacks::getBackend() == Attacks::PEXT ? "PEXT" : "Magic")
+              << " var Magic var PEXT\n";
     std::cout << "uciok\n";
 }
 
-// UCI "isready" command: signal ready.
+// UCI "isready" command: signal ready (answered at once, even while searching).
 void UCI::handleIsReady() {
-    std::cout << "readyok\n";
+    std::lock_guard<std::mutex> lock(outputMutex);
+    std::cout << "readyok" << std::endl;
+}
+
+// UCI "setoption" command: "setoption name <id> [value <x>]".
+void UCI::handleSetOption(const std::vector<std::string>& tokens) {
+    std::string name, value;
+    size_t i = 1;
+    if (i < tokens.size() && tokens[i] == "name") {
+        for (++i; i < tokens.size() && tokens[i] != "value"; ++i)
+            name += (name.empty() ? "" : " ") + tokens[i];
+    }
+    if (i < tokens.size() && tokens[i] == "value") {
+        for (++i; i < tokens.size(); ++i)
+            value += (value.empty() ? "" : " ") + tokens[i];
+    }
+
+    // Options are not changed under a running search.
+    stopSearch();
+
+    if (name == "Hash" && Utils::isInteger(value)) {
+        // Transposition table size in megabytes.
+        int megabytes = std::max(1, std::min(65536, Utils::toInt(value)));
+        if (!TT.resize(static_cast<size_t>(megabytes)))
+            std::cout << "info string Could not allocate " << megabytes << " MB for Hash, keeping the previous size\n";
+    } else if (name == "Threads" && Utils::isInteger(value)) {
+        // Number of search threads (Lazy SMP).
+        Search::setThreadCount(Utils::toInt(value));
+    } else if (name == "SliderAttacks") {
+        // Switch between the portable magic tables and the BMI2 PEXT tables.
+        if (value == "PEXT") {
+            if (!Attacks::setBackend(Attacks::PEXT))
+                std::cout << "info string PEXT is not available in this build or on this CPU, keeping Magic\n";
+        } else if (value == "Magic") {
+            Attacks::setBackend(Attacks::MAGIC);
+        }
+    }
 }
 
 // UCI "ucinewgame" command: reset to starting position.
 void UCI::handleUciNewGame() {
+    stopSearch();
     board.reset();
+    TT.clear(); // Results from the previous game are of no use
 }
 
 // UCI "position" command: set up position from FEN or startpos, and apply moves.
@@ -99,55 +165,121 @@ void UCI::handlePosition(const std::vector<std::string>& tokens) {
 }
 
 // Helper: Applies a list of moves in algebraic notation to the board.
+// UCI has no channel for reporting a bad move, so application stops silently at the first one
+// rather than playing the rest of the list from the wrong position.
 void UCI::applyMoves(const std::vector<std::string>& moves) {
     for (const auto& moveStr : moves) {
-        board.makeMove(moveStr);
+        if (board.tryMove(moveStr) != Board::MOVE_OK)
+            break;
     }
 }
 
 // UCI "go" command: initiates thinking/search.
-// For demo, supports only "go depth <n>".
+// Supports "depth <n>", "infinite", "ponder" and the clock fields "wtime", "btime", "winc", "binc",
+// "movestogo" and "movetime". Without a depth the search runs until the time manager (or "stop") ends it;
+// without either, a default depth is used. The search runs on a worker thread and this returns at once.
 void UCI::handleGo(const std::vector<std::string>& tokens) {
-    int depth = 4; // Default search depth
-    for (size_t i = 1; i < tokens.size(); ++i) {
-        if (tokens[i] == "depth" && i + 1 < tokens.size()) {
-            depth = std::stoi(tokens[i + 1]);
-        }
-        // You can add support for movetime, nodes, infinite, etc.
-    }
+    int depth = -1;
+    TimeManager::Limits limits;
+    for (size_t i = 1; i + 1 < tokens.size(); ++i) {
+        const std::string& name = tokens[i];
+        if (!Utils::isInteger(tokens[i + 1])) continue;
+        int value = Utils::toInt(tokens[i + 1]);
 
-    stopSignal = false;
+        if (name == "depth") depth = value;
+        else if (name == "wtime") limits.wtime = value;
+        else if (name == "btime") limits.btime = value;
+        else if (name == "winc") limits.winc = value;
+        else if (name == "binc") limits.binc = value;
+        else if (name == "movestogo") limits.movestogo = value;
+        else if (name == "movetime") limits.movetime = value;
+        else continue;
+        ++i;
+        // You can add support for nodes, mate, searchmoves, etc.
+    }
+    for (const auto& token : tokens) {
+        if (token == "infinite") limits.infinite = true;
+        else if (token == "ponder") limits.ponder = true;
+    }
 
-    // Search for the best move
-    auto startTime = std::chrono::steady_clock::now();
+    int ownTime = (board.getSideToMove() == Board::WHITE) ? limits.wtime : limits.btime;
+    bool timed = limits.movetime >= 0 || ownTime >= 0 || limits.infinite;
+    if (depth <= 0)
+        depth = timed ? Search::MAX_PLY : 4; // Default search depth
 
-    int score = 0;
-    Board::Move bestMove = Search::findBestMove(board, depth, score);
+    // Only one search at a time.
+    stopSearch();
+    {
+        std::lock_guard<std::mutex> lock(signalMutex);
+        stopSignal = false;
+        ponderSignal = limits.ponder;
+    }
+    Search::resetSignals();
 
-    auto endTime = std::chrono::steady_clock::now();
-    int timeMs = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count();
+    // Search a copy of the position on the worker thread, reporting after every completed depth.
+    searchThread = std::thread([this, root = board, depth, limits]() {
+        int score = 0;
+        Board::Move bestMove = Search::findBestMove(root, depth, limits, score, [this](const Search::SearchInfo& info) {
+            printInfo(info.depth, info.score, info.timeMs, info.nodes, MoveGen::moveToString(info.bestMove));
+        });
 
-    // Info line (depth, score, time, nodes)
-    printInfo(depth, score, timeMs, 0); // Node count could be added via perft or search stats.
+        // The protocol forbids "bestmove" during an infinite or pondering search until the GUI ends it.
+        if (limits.infinite || limits.ponder) {
+            std::unique_lock<std::mutex> lock(signalMutex);
+            signalChanged.wait(lock, [&]() { return stopSignal || (!limits.infinite && !ponderSignal); });
+        }
 
-    // Output best move in UCI format.
-    std::cout << "bestmove " << MoveGen::moveToString(bestMove) << "\n";
+        // Output best move in UCI format.
+        std::lock_guard<std::mutex> lock(outputMutex);
+        std::cout << "bestmove " << MoveGen::moveToString(bestMove) << std::endl;
+    });
 }
 
 // Prints an info line (for GUI feedback).
-void UCI::printInfo(int depth, int score, int timeMs, int nodes) {
-    std::cout << "info depth " << depth
-              << " score cp " << score
-              << " time " << timeMs
-              << " nodes " << nodes << "\n";
+void UCI::printInfo(int depth, int score, int timeMs, uint64_t nodes, const std::string& pv) {
+    std::lock_guard<std::mutex> lock(outputMutex);
+    std::cout << "info depth " << depth;
+    if (score >= Search::MATE_BOUND)
+        std::cout << " score mate " << (Search::MATE_SCORE - score + 1) / 2; // Moves until we mate
+    else if (score <= -Search::MATE_BOUND)
+        std::cout << " score mate " << -(Search::MATE_SCORE + score) / 2;    // Moves until we are mated
+    else
+        std::cout << " score cp " << score;
+    std::cout << " time " << timeMs
+              << " nodes " << nodes
+              << " hashfull " << TT.hashfull()
+              << " pv " << pv << std::endl; // Flush so the GUI sees progress while the search continues
 }
 
-// UCI "stop" command: sets stop signal for multi-threaded search (not used in this template).
+// UCI "stop" command: ends the current search; its best move is printed by the search thread.
 void UCI::handleStop() {
-    stopSignal = true;
+    {
+        std::lock_guard<std::mutex> lock(signalMutex);
+        stopSignal = true;
+    }
+    signalChanged.notify_all();
+    Search::stop();
+}
+
+// UCI "ponderhit" command: the opponent played the expected move, so the pondering search
+// continues as a normal search on our own clock.
+void UCI::handlePonderHit() {
+    {
+        std::lock_guard<std::mutex> lock(signalMutex);
+        ponderSignal = false;
+    }
+    signalChanged.notify_all();
+    Search::ponderhit();
+}
+
+// Helper: stops the running search (if any) and joins its thread.
+void UCI::stopSearch() {
+    if (!searchThread.joinable()) return;
+    handleStop();
+    searchThread.join();
 }
 
 // UCI "quit" command: exits the protocol handler.
 void UCI::handleQuit() {
-    // Any clean-up if needed.
+    stopSearch();
 }